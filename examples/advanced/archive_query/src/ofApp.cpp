@@ -0,0 +1,132 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofApp.h"
+
+
+void ofApp::setup()
+{
+    ofSetBackgroundColor(255);
+
+    ofx::RegisterPointerEvent(this);
+
+    results = "Draw some strokes with a pen, then press:\n\n";
+    results += "  s: save the events to events.ofxa\n";
+    results += "  h: show the pen pressure histogram from events.ofxa\n";
+    results += "  c: clear the events";
+}
+
+
+void ofApp::update()
+{
+    renderer.update();
+}
+
+
+void ofApp::draw()
+{
+    renderer.draw();
+    ofDrawBitmapStringHighlight(results, 14, 20);
+}
+
+
+void ofApp::keyPressed(int key)
+{
+    if (key == 's')
+    {
+        save();
+    }
+    else if (key == 'h')
+    {
+        query();
+    }
+    else if (key == 'c')
+    {
+        events.clear();
+        renderer.clear();
+    }
+}
+
+
+void ofApp::onPointerEvent(ofx::PointerEventArgs& e)
+{
+    renderer.add(e);
+    events.push_back(e);
+}
+
+
+void ofApp::save()
+{
+    std::ofstream stream(ofToDataPath("events.ofxa", true), std::ios::binary);
+    ofx::PointerArchiveWriter writer(stream);
+
+    for (const auto& e: events)
+        writer.add(e);
+
+    writer.close();
+
+    results = "Saved " + ofToString(writer.numEvents()) + " events in ";
+    results += ofToString(writer.numRows()) + " rows.";
+}
+
+
+void ofApp::query()
+{
+    ofx::PointerArchiveReader reader;
+
+    if (!reader.open("events.ofxa"))
+        return;
+
+    int64_t pen = reader.dictionaryId(ofx::PointerEventArgs::TYPE_PEN);
+
+    std::array<std::size_t, 10> histogram = {{ }};
+    std::size_t numSkipped = 0;
+
+    std::vector<int64_t> deviceTypes;
+    std::vector<float> pressures;
+
+    for (std::size_t chunk = 0; chunk < reader.numChunks(); ++chunk)
+    {
+        // Skip chunks without pen events using the chunk statistics.
+        if (pen < 0 || !reader.mayContain(chunk, ofx::PointerArchiveColumn::DEVICE_TYPE, pen, pen))
+        {
+            ++numSkipped;
+            continue;
+        }
+
+        // Only the device type and pressure columns are read.
+        if (!reader.readColumn(chunk, ofx::PointerArchiveColumn::DEVICE_TYPE, deviceTypes)
+        ||  !reader.readColumn(chunk, ofx::PointerArchiveColumn::PRESSURE, pressures))
+        {
+            return;
+        }
+
+        for (std::size_t i = 0; i < deviceTypes.size(); ++i)
+        {
+            if (deviceTypes[i] == pen)
+            {
+                std::size_t bin = std::size_t(ofClamp(pressures[i], 0, 1) * (histogram.size() - 1) + 0.5f);
+                ++histogram[bin];
+            }
+        }
+    }
+
+    std::stringstream ss;
+
+    ss << "Pen pressure histogram for " << reader.numRows() << " rows." << std::endl;
+    ss << "Skipped " << numSkipped << " of " << reader.numChunks() << " chunks and read ";
+    ss << reader.numBytesRead() << " column bytes." << std::endl << std::endl;
+
+    for (std::size_t i = 0; i < histogram.size(); ++i)
+    {
+        ss << "  " << ofToString(float(i) / (histogram.size() - 1), 1) << " ";
+        ss << std::setw(8) << histogram[i] << std::endl;
+    }
+
+    results = ss.str();
+    ofLogNotice("ofApp::query") << std::endl << results;
+}
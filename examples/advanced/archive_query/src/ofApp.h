@@ -0,0 +1,39 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include "ofMain.h"
+#include "ofxPointer.h"
+
+
+class ofApp: public ofBaseApp
+{
+public:
+    void setup() override;
+    void update() override;
+    void draw() override;
+
+    void keyPressed(int key) override;
+
+    void onPointerEvent(ofx::PointerEventArgs& e);
+
+    // Write the recorded events to events.ofxa.
+    void save();
+
+    // Compute a pressure histogram of pen events from events.ofxa.
+    void query();
+
+    ofx::PointerDebugRenderer renderer;
+
+    // All recorded events, in order.
+    std::vector<ofx::PointerEventArgs> events;
+
+    // The query results.
+    std::string results;
+};
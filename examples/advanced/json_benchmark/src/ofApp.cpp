@@ -0,0 +1,166 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofApp.h"
+
+
+void ofApp::setup()
+{
+    ofSetBackgroundColor(255);
+
+    ofx::RegisterPointerEvent(this);
+
+    results = "Draw some strokes, then press:\n\n";
+    results += "  b: benchmark JSON writing and reading\n";
+    results += "  s: save the events to events.jsonl\n";
+    results += "  l: load the events from events.jsonl\n";
+    results += "  c: clear the events";
+}
+
+
+void ofApp::update()
+{
+    renderer.update();
+}
+
+
+void ofApp::draw()
+{
+    renderer.draw();
+    ofDrawBitmapStringHighlight(results, 14, 20);
+}
+
+
+void ofApp::keyPressed(int key)
+{
+    if (key == 'b')
+    {
+        benchmark();
+    }
+    else if (key == 's')
+    {
+        std::ofstream stream(ofToDataPath("events.jsonl", true), std::ios::binary);
+        ofx::PointerEventJsonWriter writer(stream);
+
+        for (const auto& e: events)
+            writer.write(e);
+    }
+    else if (key == 'l')
+    {
+        std::ifstream stream(ofToDataPath("events.jsonl", true), std::ios::binary);
+        ofx::PointerEventJsonReader reader(stream);
+        ofx::PointerEventArgs e;
+
+        events.clear();
+
+        while (reader.read(e))
+            events.push_back(e);
+
+        benchmark();
+    }
+    else if (key == 'c')
+    {
+        events.clear();
+        renderer.clear();
+    }
+}
+
+
+void ofApp::onPointerEvent(ofx::PointerEventArgs& e)
+{
+    renderer.add(e);
+    events.push_back(e);
+}
+
+
+void ofApp::benchmark()
+{
+    if (events.empty())
+        return;
+
+    // Repeat the events so that short sessions can be timed.
+    std::size_t repeats = std::max(std::size_t(1), std::size_t(20000) / events.size());
+    std::size_t count = repeats * events.size();
+
+    std::vector<std::string> lines;
+    lines.reserve(events.size());
+
+    uint64_t start = ofGetElapsedTimeMicros();
+    std::size_t domBytes = 0;
+
+    for (std::size_t i = 0; i < repeats; ++i)
+    {
+        for (const auto& e: events)
+        {
+            std::string line = nlohmann::json(e).dump();
+            domBytes += line.size() + 1;
+
+            if (i == 0)
+                lines.push_back(line);
+        }
+    }
+
+    uint64_t domWriteMicros = ofGetElapsedTimeMicros() - start;
+
+    std::string buffer;
+    std::size_t streamBytes = 0;
+    start = ofGetElapsedTimeMicros();
+
+    for (std::size_t i = 0; i < repeats; ++i)
+    {
+        for (const auto& e: events)
+        {
+            // Reuse the buffer as a writer would after each flush.
+            if (buffer.size() >= ofx::PointerEventJsonWriter::BUFFER_SIZE)
+            {
+                streamBytes += buffer.size();
+                buffer.clear();
+            }
+
+            ofx::PointerEventJsonWriter::append(e, buffer);
+        }
+    }
+
+    streamBytes += buffer.size();
+    uint64_t streamWriteMicros = ofGetElapsedTimeMicros() - start;
+
+    ofx::PointerEventArgs e;
+    start = ofGetElapsedTimeMicros();
+
+    for (std::size_t i = 0; i < repeats; ++i)
+    {
+        for (const auto& line: lines)
+            e = nlohmann::json::parse(line).get<ofx::PointerEventArgs>();
+    }
+
+    uint64_t domReadMicros = ofGetElapsedTimeMicros() - start;
+
+    start = ofGetElapsedTimeMicros();
+
+    for (std::size_t i = 0; i < repeats; ++i)
+    {
+        for (const auto& line: lines)
+            ofx::PointerEventJsonReader::parse(line.data(), line.size(), e);
+    }
+
+    uint64_t streamReadMicros = ofGetElapsedTimeMicros() - start;
+
+    auto rate = [count](uint64_t micros) {
+        return ofToString(count * 1000000.0 / std::max(micros, uint64_t(1)), 0) + " events/s";
+    };
+
+    std::stringstream ss;
+
+    ss << "JSON timings for " << count << " events." << std::endl << std::endl;
+    ss << "  write to_json:   " << std::setw(10) << rate(domWriteMicros) << " " << domBytes << " bytes" << std::endl;
+    ss << "  write streaming: " << std::setw(10) << rate(streamWriteMicros) << " " << streamBytes << " bytes" << std::endl;
+    ss << "  read from_json:  " << std::setw(10) << rate(domReadMicros) << std::endl;
+    ss << "  read streaming:  " << std::setw(10) << rate(streamReadMicros) << std::endl;
+
+    results = ss.str();
+    ofLogNotice("ofApp::benchmark") << std::endl << results;
+}
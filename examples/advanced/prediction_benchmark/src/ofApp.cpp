@@ -0,0 +1,134 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofApp.h"
+
+
+void ofApp::setup()
+{
+    ofSetBackgroundColor(255);
+
+    ofx::RegisterPointerEvent(this);
+
+    results = "Draw some strokes, then press:\n\n";
+    results += "  b: benchmark the predictors\n";
+    results += "  s: save the strokes to strokes.json\n";
+    results += "  l: load the strokes from strokes.json\n";
+    results += "  c: clear the strokes";
+}
+
+
+void ofApp::update()
+{
+    renderer.update();
+}
+
+
+void ofApp::draw()
+{
+    renderer.draw();
+    ofDrawBitmapStringHighlight(results, 14, 20);
+}
+
+
+void ofApp::keyPressed(int key)
+{
+    if (key == 'b')
+    {
+        benchmark();
+    }
+    else if (key == 's')
+    {
+        ofSaveJson("strokes.json", events);
+    }
+    else if (key == 'l')
+    {
+        events = ofLoadJson("strokes.json").get<std::vector<ofx::PointerEventArgs>>();
+        benchmark();
+    }
+    else if (key == 'c')
+    {
+        events.clear();
+        renderer.clear();
+    }
+}
+
+
+void ofApp::onPointerEvent(ofx::PointerEventArgs& e)
+{
+    renderer.add(e);
+    events.push_back(e);
+}
+
+
+void ofApp::benchmark()
+{
+    // Rebuild the strokes from the recorded events.
+    std::vector<ofx::PointerStroke> strokes;
+    std::map<std::size_t, ofx::PointerStroke> activeStrokes;
+
+    for (const auto& e: events)
+    {
+        auto& stroke = activeStrokes[e.pointerId()];
+        stroke.add(e);
+
+        if (stroke.isFinished())
+        {
+            strokes.push_back(stroke);
+            activeStrokes.erase(e.pointerId());
+        }
+    }
+
+    std::vector<std::pair<std::string, std::shared_ptr<ofx::PointerPredictor>>> predictors =
+    {
+        { "Linear", std::make_shared<ofx::LinearPointerPredictor>() },
+        { "Quadratic", std::make_shared<ofx::QuadraticPointerPredictor>() },
+        { "Kalman", std::make_shared<ofx::KalmanPointerPredictor>() }
+    };
+
+    std::stringstream ss;
+
+    ss << "Prediction error in pixels for " << strokes.size() << " strokes." << std::endl;
+
+    for (uint64_t horizonMicros: { 8000, 16000, 33000 })
+    {
+        ss << std::endl << "Horizon " << horizonMicros / 1000 << " ms" << std::endl;
+
+        for (auto& predictor: predictors)
+        {
+            std::size_t count = 0;
+            double sum = 0;
+            double sumSquared = 0;
+            double max = 0;
+
+            for (const auto& stroke: strokes)
+            {
+                auto error = ofx::measurePredictionError(*predictor.second,
+                                                         stroke,
+                                                         horizonMicros);
+                count += error.count;
+                sum += error.mean * error.count;
+                sumSquared += error.rms * error.rms * error.count;
+                max = std::max(max, error.max);
+            }
+
+            ss << "  " << std::left << std::setw(10) << predictor.first;
+
+            if (count > 0)
+            {
+                ss << " mean: " << ofToString(sum / count, 2);
+                ss << " rms: " << ofToString(std::sqrt(sumSquared / count), 2);
+                ss << " max: " << ofToString(max, 2);
+            }
+
+            ss << " n: " << count << std::endl;
+        }
+    }
+
+    results = ss.str();
+    ofLogNotice("ofApp::benchmark") << std::endl << results;
+}
@@ -0,0 +1,36 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include "ofMain.h"
+#include "ofxPointer.h"
+
+
+class ofApp: public ofBaseApp
+{
+public:
+    void setup() override;
+    void update() override;
+    void draw() override;
+
+    void keyPressed(int key) override;
+
+    void onPointerEvent(ofx::PointerEventArgs& e);
+
+    // Measure the prediction error of each predictor on the recorded strokes.
+    void benchmark();
+
+    ofx::PointerDebugRenderer renderer;
+
+    // All recorded events, in order.
+    std::vector<ofx::PointerEventArgs> events;
+
+    // The benchmark results.
+    std::string results;
+};
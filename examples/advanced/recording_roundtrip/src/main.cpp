@@ -0,0 +1,223 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofMain.h"
+#include "ofxPointer.h"
+
+
+// Encode events as a binary recording, decode them and compare the to_json()
+// representation of every event. Exits with a failure on any mismatch.
+
+
+// Round a value to the quantization grid, or keep it if step is 0.
+float snap(float value, float step)
+{
+    return step > 0 ? std::round(value / step) * step : value;
+}
+
+
+// Create events covering every encoded field.
+std::vector<ofx::PointerEventArgs> makeEvents(std::size_t numEvents, float step)
+{
+    std::vector<ofx::PointerEventArgs> events;
+
+    uint64_t timestampMicros = 123456789;
+    uint64_t sequenceIndex = 1000;
+
+    auto position = [&]()
+    {
+        return glm::vec2(snap(ofRandom(-100, 2000), step),
+                         snap(ofRandom(-100, 2000), step));
+    };
+
+    for (std::size_t i = 0; i < numEvents; ++i)
+    {
+        timestampMicros += 1000 + (i % 5) * 37;
+        sequenceIndex += 1;
+
+        ofx::PointerSampleBuffer coalesced;
+        ofx::PointerSampleBuffer predicted;
+
+        for (std::size_t j = 0; j < i % 4; ++j)
+        {
+            ofx::PointerSample sample;
+            sample.point = ofx::Point(position(), position(), ofx::PointShape(), ofRandom(1), 0, 0, 10, -5);
+            sample.timestampMicros = timestampMicros - (3 - j) * 250;
+            sample.sequenceIndex = sequenceIndex - (3 - j);
+            sample.flags = ofx::PointerSample::FLAG_COALESCED;
+            sample.estimatedProperties = ofx::POINTER_PROPERTY_PRESSURE;
+            coalesced.push_back(sample);
+        }
+
+        for (std::size_t j = 0; j < i % 3; ++j)
+        {
+            ofx::PointerSample sample;
+            sample.point = ofx::Point(position());
+            sample.timestampMicros = timestampMicros + (j + 1) * 8000;
+            sample.flags = ofx::PointerSample::FLAG_PREDICTED;
+            predicted.push_back(sample);
+        }
+
+        ofx::Point point(position(),
+                         position(),
+                         ofx::PointShape(ofx::PointShape::ShapeType::RECTANGLE, 3, 4, 0.5f, 0.25f, 30),
+                         ofRandom(1),
+                         0.1f,
+                         45,
+                         10,
+                         -20);
+
+        // Every eleventh event has custom event and device types, which are
+        // stored as strings.
+        bool isCustom = i % 11 == 10;
+
+        ofx::PointerEventType eventType = i % 7 == 0 ? ofx::PointerEventType::POINTER_DOWN
+                                                     : ofx::PointerEventType::POINTER_MOVE;
+
+        ofx::PointerDeviceType deviceType = i % 5 == 0 ? ofx::PointerDeviceType::PEN
+                                                       : ofx::PointerDeviceType::TOUCH;
+
+        events.push_back(ofx::PointerEventArgs::toPointerEventArgs(nullptr,
+                                                                   isCustom ? "custom_event" : ofx::to_string(eventType),
+                                                                   timestampMicros,
+                                                                   i % 4,
+                                                                   point,
+                                                                   0x9e3779b97f4a7c15ULL + (i % 3),
+                                                                   -3,
+                                                                   int64_t(i % 3),
+                                                                   sequenceIndex,
+                                                                   isCustom ? "custom_device" : ofx::to_string(deviceType),
+                                                                   false,
+                                                                   false,
+                                                                   i % 3 == 0,
+                                                                   int16_t(i % 2 ? -1 : 0),
+                                                                   uint16_t(i % 4),
+                                                                   uint16_t(i % 8),
+                                                                   coalesced.samples(),
+                                                                   predicted.samples(),
+                                                                   ofx::POINTER_PROPERTY_PRESSURE | ofx::POINTER_PROPERTY_TILT_X,
+                                                                   ofx::POINTER_PROPERTY_PRESSURE));
+    }
+
+    return events;
+}
+
+
+// Compare a decoded event to the original, logging any difference.
+bool compare(const ofx::PointerEventArgs& original,
+             const ofx::PointerEventArgs& decoded,
+             std::size_t index)
+{
+    nlohmann::json expected = original;
+    nlohmann::json actual = decoded;
+
+    if (expected == actual)
+        return true;
+
+    ofLogError("compare") << "Event " << index << " does not match.";
+    ofLogError("compare") << "Expected: " << expected.dump();
+    ofLogError("compare") << "  Actual: " << actual.dump();
+    return false;
+}
+
+
+// Round trip events through the encoder, the decoder and the stream reader.
+bool roundTrip(const std::vector<ofx::PointerEventArgs>& events,
+               const ofx::PointerRecordingFormat& format)
+{
+    ofx::PointerEventEncoder encoder(format);
+    std::vector<uint8_t> buffer;
+    encoder.encodeHeader(buffer);
+
+    for (const auto& e: events)
+        encoder.encode(e, buffer);
+
+    ofx::PointerEventDecoder decoder;
+    std::size_t offset = decoder.decodeHeader(buffer.data(), buffer.size());
+
+    if (offset == 0)
+    {
+        ofLogError("roundTrip") << "Invalid header.";
+        return false;
+    }
+
+    for (std::size_t i = 0; i < events.size(); ++i)
+    {
+        ofx::PointerEventArgs e;
+        std::size_t numBytes = decoder.decode(buffer.data() + offset, buffer.size() - offset, e);
+
+        if (numBytes == 0)
+        {
+            ofLogError("roundTrip") << "Unable to decode event " << i << ".";
+            return false;
+        }
+
+        if (!compare(events[i], e, i))
+            return false;
+
+        offset += numBytes;
+    }
+
+    if (offset != buffer.size())
+    {
+        ofLogError("roundTrip") << "Unexpected bytes after the last event.";
+        return false;
+    }
+
+    std::stringstream stream(std::string(buffer.begin(), buffer.end()));
+    ofx::PointerEventReader reader(stream);
+
+    for (std::size_t i = 0; i < events.size(); ++i)
+    {
+        ofx::PointerEventArgs e;
+
+        if (!reader.read(e))
+        {
+            ofLogError("roundTrip") << "PointerEventReader failed at event " << i << ".";
+            return false;
+        }
+
+        if (!compare(events[i], e, i))
+            return false;
+    }
+
+    ofLogNotice("roundTrip") << events.size() << " events in " << buffer.size() << " bytes with positionScale " << format.positionScale << ".";
+    return true;
+}
+
+
+int main()
+{
+    ofSeedRandom(3);
+
+    bool success = true;
+
+    // Exact float positions.
+    ofx::PointerRecordingFormat exact;
+    exact.keyframeInterval = 16;
+    success &= roundTrip(makeEvents(1000, 0), exact);
+
+    // Quantized positions that are already on the grid are unchanged.
+    ofx::PointerRecordingFormat quantized;
+    quantized.positionScale = 16;
+    quantized.keyframeInterval = 16;
+    success &= roundTrip(makeEvents(1000, 1.0f / quantized.positionScale), quantized);
+
+    // Only the first event is a keyframe.
+    ofx::PointerRecordingFormat firstKeyframeOnly;
+    firstKeyframeOnly.keyframeInterval = 0;
+    success &= roundTrip(makeEvents(1000, 0), firstKeyframeOnly);
+
+    if (!success)
+    {
+        ofLogFatalError("main") << "Round trip failed.";
+        return EXIT_FAILURE;
+    }
+
+    ofLogNotice("main") << "Round trip passed.";
+    return EXIT_SUCCESS;
+}
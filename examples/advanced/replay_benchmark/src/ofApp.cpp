@@ -0,0 +1,116 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include "ofApp.h"
+
+
+void ofApp::setup()
+{
+    ofSetBackgroundColor(255);
+
+    events = ofx::PointerEventsManager::instance().eventsForWindow(ofGetWindowPtr());
+
+    ofx::RegisterPointerEvent(this);
+
+    help = "Press:\n\n";
+    help += "  r: start or stop recording to session.ofxp\n";
+    help += "  p: play the recording in real time\n";
+    help += "  2: play the recording at double speed\n";
+    help += "  b: play the recording as fast as possible\n";
+    help += "  c: clear the strokes";
+}
+
+
+void ofApp::update()
+{
+    if (player.isPlaying())
+    {
+        player.update();
+
+        if (!player.isPlaying() && std::isinf(player.getSpeed()))
+        {
+            uint64_t elapsedMicros = ofGetElapsedTimeMicros() - benchmarkStartMicros;
+            double eventsPerSecond = player.numEvents() * 1000000.0 / std::max(elapsedMicros, uint64_t(1));
+            results = "Played " + ofToString(player.numEvents()) + " events in ";
+            results += ofToString(elapsedMicros / 1000.0, 2) + " ms (";
+            results += ofToString(eventsPerSecond, 0) + " events per second).";
+            ofLogNotice("ofApp::update") << results;
+        }
+    }
+
+    renderer.update();
+}
+
+
+void ofApp::draw()
+{
+    renderer.draw();
+
+    std::string status = help + "\n\n";
+
+    if (recorder.isRecording())
+        status += "Recording: " + ofToString(recorder.numEvents()) + " events";
+    else if (player.isPlaying())
+        status += "Playing: " + ofToString(player.numEvents()) + " events";
+    else
+        status += results;
+
+    ofDrawBitmapStringHighlight(status, 14, 20);
+}
+
+
+void ofApp::keyPressed(int key)
+{
+    if (key == 'r')
+    {
+        if (recorder.isRecording())
+            recorder.stop();
+        else if (events)
+        {
+            player.stop();
+            renderer.clear();
+            recorder.start(*events, "session.ofxp");
+        }
+    }
+    else if (key == 'p')
+    {
+        play(1);
+    }
+    else if (key == '2')
+    {
+        play(2);
+    }
+    else if (key == 'b')
+    {
+        play(ofx::PointerEventPlayer::AS_FAST_AS_POSSIBLE);
+    }
+    else if (key == 'c')
+    {
+        renderer.clear();
+    }
+}
+
+
+void ofApp::onPointerEvent(ofx::PointerEventArgs& e)
+{
+    renderer.add(e);
+}
+
+
+void ofApp::play(double speed)
+{
+    recorder.stop();
+
+    if (events && player.load("session.ofxp"))
+    {
+        renderer.clear();
+        results.clear();
+        player.setSpeed(speed);
+        benchmarkStartMicros = ofGetElapsedTimeMicros();
+        player.play(*events);
+    }
+}
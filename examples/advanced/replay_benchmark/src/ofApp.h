@@ -0,0 +1,43 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#pragma once
+
+
+#include "ofMain.h"
+#include "ofxPointer.h"
+
+
+class ofApp: public ofBaseApp
+{
+public:
+    void setup() override;
+    void update() override;
+    void draw() override;
+
+    void keyPressed(int key) override;
+
+    void onPointerEvent(ofx::PointerEventArgs& e);
+
+    // Play the recording at the given speed.
+    void play(double speed);
+
+    // The pointer events of the main window.
+    ofx::PointerEvents* events = nullptr;
+
+    ofx::PointerDebugRenderer renderer;
+
+    ofx::PointerEventRecorder recorder;
+    ofx::PointerEventPlayer player;
+
+    // The time the benchmark started in microseconds.
+    uint64_t benchmarkStartMicros = 0;
+
+    // The help text and results.
+    std::string help;
+    std::string results;
+};
@@ -8,16 +8,28 @@
 #pragma once
 
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iterator>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include "json.hpp"
 #include "ofEvents.h"
 #include "ofColor.h"
 #include "ofUtils.h"
 #include "ofAppBaseWindow.h"
 #include "ofAppRunner.h"
+#include "ofMesh.h"
 #include "ofRectangle.h"
+#include "ofVboMesh.h"
 #include "ofLog.h"
 
 
@@ -27,6 +39,7 @@ namespace ofx {
 class PointShape;
 class Point;
 class PointerEventArgs;
+class PointerPredictor;
 
 
 /// \brief A base class describing the basic components of event arguments.
@@ -57,7 +70,7 @@ public:
     const void* eventSource() const;
 
     /// \returns the event type.
-    std::string eventType() const;
+    const std::string& eventType() const;
 
     /// \returns the timestamp of this event in milliseconds.
     uint64_t timestampMillis() const;
@@ -71,13 +84,54 @@ public:
     /// \brief An unknown event type.
     static const std::string EVENT_TYPE_UNKNOWN;
 
+    /// \brief The maximum number of distinct custom type strings.
+    ///
+    /// Once this many custom event and device types have been seen, further
+    /// custom types are replaced by EVENT_TYPE_UNKNOWN or the unknown device
+    /// type, so data from an untrusted recording cannot grow memory without
+    /// bound.
+    static constexpr std::size_t MAX_INTERNED_STRINGS = 1024;
+
+protected:
+    /// \brief Create a BaseEventArgs with an interned event type.
+    /// \param eventSource The source of the event.
+    /// \param eventType An interned event type string that outlives the event.
+    /// \param timestampMicros The timestamp of the event in microseconds.
+    /// \param detail Optional event detail.
+    EventArgs(const void* eventSource,
+              const std::string* eventType,
+              uint64_t timestampMicros,
+              uint64_t detail);
+
+    /// \brief Replace the event type with an interned event type string.
+    /// \param eventType An interned event type string that outlives the event.
+    void _setEventType(const std::string* eventType);
+
+    /// \brief Intern a string so that it can be shared by reference.
+    ///
+    /// Interned strings are never released, so at most MAX_INTERNED_STRINGS
+    /// are kept. Once the limit is reached, new strings are replaced by the
+    /// fallback.
+    ///
+    /// \param value The string to intern.
+    /// \param fallback The string to use if value cannot be interned. It
+    ///     must never be released.
+    /// \returns a pointer to a string equal to value, or to fallback, that is
+    ///     never released.
+    static const std::string* _intern(const std::string& value,
+                                      const std::string& fallback = EVENT_TYPE_UNKNOWN);
+
 private:
     /// \brief A pointer to the event source.
     const void* _eventSource = nullptr;
 
     /// \brief The name of this event type.
+    ///
+    /// Event types are interned so that copying an event never copies the
+    /// type string.
+    ///
     /// \sa https://dom.spec.whatwg.org/#dom-event-type
-    std::string _eventType;
+    const std::string* _eventType = &EVENT_TYPE_UNKNOWN;
 
     /// \brief The timestamp of this event in microseconds.
     uint64_t _timestampMicros = 0;
@@ -583,6 +637,309 @@ inline void from_json(const nlohmann::json& j, Point& v)
 }
 
 
+/// \brief The pointer event types.
+///
+/// Each value corresponds to one of the PointerEventArgs event type strings
+/// (e.g. PointerEventType::POINTER_DOWN and PointerEventArgs::POINTER_DOWN).
+///
+/// \sa https://w3c.github.io/pointerevents/#pointer-event-types
+enum class PointerEventType: uint8_t
+{
+    UNKNOWN, /// \brief An unknown or custom event type.
+    POINTER_OVER,
+    POINTER_ENTER,
+    POINTER_DOWN,
+    POINTER_MOVE,
+    POINTER_UP,
+    POINTER_CANCEL,
+    POINTER_UPDATE,
+    POINTER_OUT,
+    POINTER_LEAVE,
+    POINTER_SCROLL,
+    GOT_POINTER_CAPTURE,
+    LOST_POINTER_CAPTURE
+};
+
+
+/// \brief The pointer device types.
+///
+/// Each value corresponds to one of the PointerEventArgs device type strings
+/// (e.g. PointerDeviceType::PEN and PointerEventArgs::TYPE_PEN).
+///
+/// \sa https://w3c.github.io/pointerevents/#dom-pointerevent-pointertype
+enum class PointerDeviceType: uint8_t
+{
+    UNKNOWN, /// \brief An unknown or custom device type.
+    MOUSE,
+    PEN,
+    TOUCH
+};
+
+
+/// \brief A bitmask of Point properties.
+///
+/// Used to describe the estimated properties of a pointer event and the
+/// estimated properties that are expecting updates.
+typedef uint8_t PointerPropertyMask;
+
+
+/// \brief The Point properties that may be estimated and later updated.
+enum PointerProperty: PointerPropertyMask
+{
+    POINTER_PROPERTY_NONE = 0,
+    POINTER_PROPERTY_POSITION = 1 << 0,
+    POINTER_PROPERTY_PRESSURE = 1 << 1,
+    POINTER_PROPERTY_TILT_X = 1 << 2,
+    POINTER_PROPERTY_TILT_Y = 1 << 3
+};
+
+
+/// \brief Convert property names to a PointerPropertyMask.
+/// \param properties A set of property names, e.g. PointerEventArgs::PROPERTY_PRESSURE.
+/// \returns the matching PointerPropertyMask.
+PointerPropertyMask toPointerPropertyMask(const std::set<std::string>& properties);
+
+/// \brief Convert a PointerPropertyMask to property names.
+/// \param properties The properties to convert.
+/// \returns a set of property names, e.g. PointerEventArgs::PROPERTY_PRESSURE.
+std::set<std::string> toPointerPropertyNames(PointerPropertyMask properties);
+
+
+/// \returns the event type string for the given PointerEventType.
+const std::string& to_string(PointerEventType v);
+
+/// \returns the device type string for the given PointerDeviceType.
+const std::string& to_string(PointerDeviceType v);
+
+/// \brief Convert an event type string to a PointerEventType.
+/// \param eventType The event type string, e.g. PointerEventArgs::POINTER_DOWN.
+/// \returns the matching PointerEventType or PointerEventType::UNKNOWN.
+PointerEventType toPointerEventType(const std::string& eventType);
+
+/// \brief Convert a device type string to a PointerDeviceType.
+/// \param deviceType The device type string, e.g. PointerEventArgs::TYPE_PEN.
+/// \returns the matching PointerDeviceType or PointerDeviceType::UNKNOWN.
+PointerDeviceType toPointerDeviceType(const std::string& deviceType);
+
+
+/// \brief A non-owning view of a contiguous sequence of values.
+///
+/// A Span is only valid as long as the storage it views is valid and
+/// unmodified.
+///
+/// \tparam T The viewed value type.
+template <typename T>
+class Span
+{
+public:
+    typedef const T* const_iterator;
+
+    /// \brief Create an empty Span.
+    Span()
+    {
+    }
+
+    /// \brief Create a Span with the given data.
+    /// \param data A pointer to the first value.
+    /// \param size The number of values.
+    Span(const T* data, std::size_t size): _data(data), _size(size)
+    {
+    }
+
+    /// \brief Create a Span viewing a vector.
+    /// \param values The values to view.
+    Span(const std::vector<T>& values): _data(values.data()), _size(values.size())
+    {
+    }
+
+    /// \returns an iterator to the first value.
+    const_iterator begin() const
+    {
+        return _data;
+    }
+
+    /// \returns an iterator past the last value.
+    const_iterator end() const
+    {
+        return _data + _size;
+    }
+
+    /// \returns a pointer to the first value.
+    const T* data() const
+    {
+        return _data;
+    }
+
+    /// \returns the number of values.
+    std::size_t size() const
+    {
+        return _size;
+    }
+
+    /// \returns true if size() == 0.
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    /// \returns the first value. The Span must not be empty.
+    const T& front() const
+    {
+        return _data[0];
+    }
+
+    /// \returns the last value. The Span must not be empty.
+    const T& back() const
+    {
+        return _data[_size - 1];
+    }
+
+    /// \returns the value at the given index.
+    const T& operator [] (std::size_t index) const
+    {
+        return _data[index];
+    }
+
+private:
+    /// \brief A pointer to the first value.
+    const T* _data = nullptr;
+
+    /// \brief The number of values.
+    std::size_t _size = 0;
+
+};
+
+
+/// \brief A coalesced or predicted sample belonging to a pointer event.
+///
+/// Samples carry only the values that differ between the samples of a single
+/// pointer event. The pointer id, device and button state are shared with the
+/// PointerEventArgs that owns them.
+struct PointerSample
+{
+    /// \brief Flags describing the sample.
+    enum Flags: uint8_t
+    {
+        FLAG_NONE = 0,
+        FLAG_COALESCED = 1 << 0, /// \brief The sample was delivered as coalesced.
+        FLAG_PREDICTED = 1 << 1 /// \brief The sample was predicted rather than measured.
+    };
+
+    /// \returns true if the sample was delivered as coalesced.
+    bool isCoalesced() const
+    {
+        return flags & FLAG_COALESCED;
+    }
+
+    /// \returns true if the sample was predicted rather than measured.
+    bool isPredicted() const
+    {
+        return flags & FLAG_PREDICTED;
+    }
+
+    /// \returns the position of the sample in screen coordinates.
+    glm::vec2 position() const
+    {
+        return point.position();
+    }
+
+    /// \brief The location and orientation of the pointer.
+    Point point;
+
+    /// \brief The timestamp of the sample in microseconds.
+    uint64_t timestampMicros = 0;
+
+    /// \brief The sequence index of the sample or zero if not supported.
+    uint64_t sequenceIndex = 0;
+
+    /// \brief The sample Flags.
+    uint8_t flags = FLAG_NONE;
+
+    /// \brief The estimated properties.
+    PointerPropertyMask estimatedProperties = POINTER_PROPERTY_NONE;
+
+    /// \brief The estimated properties that are expecting updates.
+    PointerPropertyMask estimatedPropertiesExpectingUpdates = POINTER_PROPERTY_NONE;
+
+};
+
+
+/// \brief A contiguous buffer of PointerSamples with inline storage.
+///
+/// A single sample is stored inline, so events holding only the copy of
+/// themselves do not allocate. Larger numbers of samples are moved to the
+/// heap. The inline storage is kept small because it is part of every
+/// PointerEventArgs.
+class PointerSampleBuffer
+{
+public:
+    /// \brief The number of samples stored without allocating.
+    static constexpr std::size_t INLINE_CAPACITY = 1;
+
+    /// \brief Create an empty PointerSampleBuffer.
+    PointerSampleBuffer();
+
+    /// \brief Create a PointerSampleBuffer with a copy of the given samples.
+    /// \param samples The samples to copy.
+    PointerSampleBuffer(Span<PointerSample> samples);
+
+    /// \brief Add a sample to the end of the buffer.
+    /// \param sample The sample to add.
+    void push_back(const PointerSample& sample);
+
+    /// \brief Remove all samples, keeping any allocated capacity.
+    void clear();
+
+    /// \brief Allocate storage so the given number of samples can be added
+    /// or copied in without allocating.
+    /// \param numSamples The number of samples.
+    void reserve(std::size_t numSamples);
+
+    /// \returns the number of samples.
+    std::size_t size() const;
+
+    /// \returns true if size() == 0.
+    bool empty() const;
+
+    /// \returns a pointer to the first sample.
+    PointerSample* data();
+
+    /// \returns a pointer to the first sample.
+    const PointerSample* data() const;
+
+    /// \returns a Span viewing the samples.
+    Span<PointerSample> samples() const;
+
+private:
+    /// \brief Inline storage used while size() <= INLINE_CAPACITY.
+    std::array<PointerSample, INLINE_CAPACITY> _inline;
+
+    /// \brief Heap storage used once size() > INLINE_CAPACITY.
+    std::vector<PointerSample> _heap;
+
+    /// \brief The number of samples.
+    std::size_t _size = 0;
+
+};
+
+
+/// \brief The arguments sent when estimated pointer properties are updated.
+///
+/// Stored events are identified by their pointer id and sequence index.
+struct PointerPropertyUpdateEventArgs
+{
+    /// \brief The pointer id of the updated event.
+    std::size_t pointerId = 0;
+
+    /// \brief The sequence index of the updated event.
+    uint64_t sequenceIndex = 0;
+
+    /// \brief The properties that were updated.
+    PointerPropertyMask updatedProperties = POINTER_PROPERTY_NONE;
+
+};
+
+
 /// \brief A class representing all of the arguments in a pointer event.
 ///
 /// PointerEventArgs are usually passed as arguments in the openFrameworks event
@@ -604,6 +961,12 @@ public:
     PointerEventArgs(const std::string& eventType,
                      const PointerEventArgs& event);
 
+    /// \brief Create a copy of the event with a new event type.
+    /// \param eventType The new event type.
+    /// \param event the event to copy.
+    PointerEventArgs(PointerEventType eventType,
+                     const PointerEventArgs& event);
+
     /// \brief Create a PointerEventArgs with parameters.
     /// \param eventSource The event source if available.
     /// \param eventType The pointer event type.
@@ -648,10 +1011,70 @@ public:
                      const std::set<std::string>& estimatedProperties,
                      const std::set<std::string>& estimatedPropertiesExpectingUpdates);
 
+    /// \brief Create a PointerEventArgs with parameters.
+    /// \param eventSource The event source if available.
+    /// \param eventType The pointer event type.
+    /// \param timestampMicros The timestamp of this event in microseconds
+    /// \param detail The optional event details.
+    /// \param point The point.
+    /// \param pointerId The unique pointer id.
+    /// \param deviceId The unique input device id.
+    /// \param pointerIndex The unique pointer index for the given device id.
+    /// \param sequenceIndex The sequence index for this event or zero if not supported..
+    /// \param deviceType The device type.
+    /// \param isCoalesced Is this event delivered as coalesced.
+    /// \param isPredicted Is this event predicted rather than measured.
+    /// \param isPrimary True if this pointer is the primary pointer.
+    /// \param button The button id for this event.
+    /// \param buttons All pressed buttons for this pointer.
+    /// \param modifiers All modifiers for this pointer.
+    /// \param coalescedPointerEvents Samples not delivered since the last frame, including a copy of the current event.
+    /// \param predictedPointerEvents Predicted samples that will arrive between now and the next frame.
+    /// \param estimatedProperties The estimated properties.
+    /// \param estimatedPropertiesExpectingUpdates The estimated properties that are expecting updates.
+    PointerEventArgs(const void* eventSource,
+                     PointerEventType eventType,
+                     uint64_t timestampMicros,
+                     uint64_t detail,
+                     const Point& point,
+                     std::size_t pointerId,
+                     int64_t deviceId,
+                     int64_t pointerIndex,
+                     uint64_t sequenceIndex,
+                     PointerDeviceType deviceType,
+                     bool isCoalesced,
+                     bool isPredicted,
+                     bool isPrimary,
+                     int16_t button,
+                     uint16_t buttons,
+                     uint16_t modifiers,
+                     Span<PointerSample> coalescedPointerEvents,
+                     Span<PointerSample> predictedPointerEvents,
+                     PointerPropertyMask estimatedProperties,
+                     PointerPropertyMask estimatedPropertiesExpectingUpdates);
+
+    /// \brief Create an event for a coalesced or predicted sample of an event.
+    ///
+    /// The new event shares the type, pointer, device and button state of the
+    /// given event and has no coalesced or predicted samples of its own.
+    ///
+    /// \param event The event that owns the sample.
+    /// \param sample The sample.
+    PointerEventArgs(const PointerEventArgs& event,
+                     const PointerSample& sample);
+
 
     /// \brief Destroy the pointer event args.
     virtual ~PointerEventArgs();
 
+    /// \brief Get the pointer event type.
+    ///
+    /// This is a compact representation of eventType(). Custom event types
+    /// are reported as PointerEventType::UNKNOWN.
+    ///
+    /// \returns the pointer event type.
+    PointerEventType pointerEventType() const;
+
     /// \returns the Point data associated with this event.
     Point point() const;
 
@@ -695,7 +1118,15 @@ public:
     /// This string may be TYPE_MOUSE, TYPE_TOUCH, TYPE_PEN, or a custom string.
     ///
     /// \returns a device description string.
-    std::string deviceType() const;
+    const std::string& deviceType() const;
+
+    /// \brief Get the pointer device type.
+    ///
+    /// This is a compact representation of deviceType(). Custom device types
+    /// are reported as PointerDeviceType::UNKNOWN.
+    ///
+    /// \returns the pointer device type.
+    PointerDeviceType pointerDeviceType() const;
 
     /// \returns true if the event was delivered as a coalesced event.
     bool isCoalesced() const;
@@ -708,7 +1139,7 @@ public:
     /// \sa https://w3c.github.io/pointerevents/#the-primary-pointer
     bool isPrimary() const;
 
-    /// \returns true if estimatedProperties().size() > 0.
+    /// \returns true if estimatedProperties() != POINTER_PROPERTY_NONE.
     bool isEstimated() const;
 
     /// \brief Get the button id for this event.
@@ -726,29 +1157,57 @@ public:
     /// \returns all modifiers for this pointer.
     uint16_t modifiers() const;
 
-    /// \returns pointer events not delivered since the last frame, including a copy of the current event.
-    std::vector<PointerEventArgs> coalescedPointerEvents() const;
+    /// \brief Get the samples not delivered since the last frame.
+    ///
+    /// The samples include a copy of the current event. The returned Span is
+    /// valid as long as this event is valid and unmodified.
+    ///
+    /// \returns samples not delivered since the last frame.
+    Span<PointerSample> coalescedPointerEvents() const;
+
+    /// \brief Get the predicted samples.
+    ///
+    /// The returned Span is valid as long as this event is valid and
+    /// unmodified.
+    ///
+    /// \returns predicted samples that will arrive between now and the next frame.
+    Span<PointerSample> predictedPointerEvents() const;
+
+    /// \brief Allocate storage for coalesced and predicted samples.
+    ///
+    /// Assigning an event with up to the given total number of samples to
+    /// this event will then reuse the storage.
+    ///
+    /// \param numSamples The total number of samples.
+    void reserveSamples(std::size_t numSamples);
 
-    /// \returns predicted pointer events that will arrive between now and the next frame.
-    std::vector<PointerEventArgs> predictedPointerEvents() const;
+    /// \returns this event as a PointerSample.
+    PointerSample toPointerSample() const;
 
-    /// \returns a set of estimated properties.
-    std::set<std::string> estimatedProperties() const;
+    /// \returns the estimated properties.
+    PointerPropertyMask estimatedProperties() const;
 
-    /// \returns a set of estimated properties that are expecting updates.
-    std::set<std::string> estimatedPropertiesExpectingUpdates() const;
+    /// \returns the estimated properties that are expecting updates.
+    PointerPropertyMask estimatedPropertiesExpectingUpdates() const;
 
     /// \brief Attempt to update properties with the given event.
     ///
     /// A property will be updated if:
     ///
     ///     - The sequence() of both events is the same.
-    ///     - The updated property name is in the estimatedProperties() set.
-    ///     - The updated property name is in the estimatedPropertiesExpectingUpdates() set.
+    ///     - The property is in this event's estimatedPropertiesExpectingUpdates().
+    ///     - The property is not in the given event's estimatedProperties().
     ///
     /// \returns true if this event was successfully updated.
     bool updateEstimatedPropertiesWithEvent(const PointerEventArgs& e);
 
+    /// \brief Attempt to update properties with the given event.
+    /// \param e The event containing the updated properties.
+    /// \param updatedProperties Set to the properties that were updated.
+    /// \returns true if this event was successfully updated.
+    bool updateEstimatedPropertiesWithEvent(const PointerEventArgs& e,
+                                            PointerPropertyMask& updatedProperties);
+
     /// \brief Utility to convert ofTouchEventArgs events to PointerEventArgs.
     /// \todo Does not set "isPrimary" correctly since it has no context.
     /// \param source The event source.
@@ -765,6 +1224,86 @@ public:
     static PointerEventArgs toPointerEventArgs(const void* source,
                                                const ofMouseEventArgs& e);
 
+    /// \brief Convert ofTouchEventArgs events to PointerEventArgs.
+    ///
+    /// Unlike toPointerEventArgs(source, e), this does not query the
+    /// application's timer or key state.
+    ///
+    /// \todo Does not set "isPrimary" correctly since it has no context.
+    /// \param source The event source.
+    /// \param e The touch event to convert.
+    /// \param timestampMicros The timestamp of the event in microseconds.
+    /// \param modifiers The modifiers currently pressed.
+    /// \returns a PointerEventArgs.
+    static PointerEventArgs toPointerEventArgs(const void* source,
+                                               const ofTouchEventArgs& e,
+                                               uint64_t timestampMicros,
+                                               uint16_t modifiers);
+
+    /// \brief Convert ofMouseEventArgs events to PointerEventArgs.
+    ///
+    /// Unlike toPointerEventArgs(source, e), this does not query the
+    /// application's timer, mouse or key state.
+    ///
+    /// \param source The event source.
+    /// \param e The mouse event to convert.
+    /// \param timestampMicros The timestamp of the event in microseconds.
+    /// \param buttons The mouse buttons currently pressed.
+    /// \param modifiers The modifiers currently pressed.
+    /// \returns a PointerEventArgs.
+    static PointerEventArgs toPointerEventArgs(const void* source,
+                                               const ofMouseEventArgs& e,
+                                               uint64_t timestampMicros,
+                                               uint16_t buttons,
+                                               uint16_t modifiers);
+
+    /// \brief Create a PointerEventArgs with event and device type strings.
+    ///
+    /// Custom event and device types that are not part of PointerEventType or
+    /// PointerDeviceType are preserved.
+    ///
+    /// \param source The event source if available.
+    /// \param eventType The event type string.
+    /// \param timestampMicros The timestamp of this event in microseconds
+    /// \param detail The optional event details.
+    /// \param point The point.
+    /// \param pointerId The unique pointer id.
+    /// \param deviceId The unique input device id.
+    /// \param pointerIndex The unique pointer index for the given device id.
+    /// \param sequenceIndex The sequence index for this event or zero if not supported.
+    /// \param deviceType The device type string.
+    /// \param isCoalesced Is this event delivered as coalesced.
+    /// \param isPredicted Is this event predicted rather than measured.
+    /// \param isPrimary True if this pointer is the primary pointer.
+    /// \param button The button id for this event.
+    /// \param buttons All pressed buttons for this pointer.
+    /// \param modifiers All modifiers for this pointer.
+    /// \param coalescedPointerEvents Samples not delivered since the last frame, including a copy of the current event.
+    /// \param predictedPointerEvents Predicted samples that will arrive between now and the next frame.
+    /// \param estimatedProperties The estimated properties.
+    /// \param estimatedPropertiesExpectingUpdates The estimated properties that are expecting updates.
+    /// \returns a PointerEventArgs.
+    static PointerEventArgs toPointerEventArgs(const void* source,
+                                               const std::string& eventType,
+                                               uint64_t timestampMicros,
+                                               uint64_t detail,
+                                               const Point& point,
+                                               std::size_t pointerId,
+                                               int64_t deviceId,
+                                               int64_t pointerIndex,
+                                               uint64_t sequenceIndex,
+                                               const std::string& deviceType,
+                                               bool isCoalesced,
+                                               bool isPredicted,
+                                               bool isPrimary,
+                                               int16_t button,
+                                               uint16_t buttons,
+                                               uint16_t modifiers,
+                                               Span<PointerSample> coalescedPointerEvents,
+                                               Span<PointerSample> predictedPointerEvents,
+                                               PointerPropertyMask estimatedProperties,
+                                               PointerPropertyMask estimatedPropertiesExpectingUpdates);
+
     /// \brief A debug utility for viewing the contents of PointerEventArgs.
     /// \returns A string representation of the PointerEventArgs.
     std::string toString() const
@@ -787,11 +1326,6 @@ public:
         return ss.str();
     }
 
-    /// \brief An event that is called when a property is updated.
-    ///
-    /// The name of the property is sent with the event.
-    ofEvent<std::string> pointerPropertyUpdate;
-
     /// \brief The mouse pointer type.
     static const std::string TYPE_MOUSE;
 
@@ -857,6 +1391,12 @@ public:
     friend std::ostream& operator << (std::ostream& os, const PointerEventArgs& e);
 
 private:
+    /// \brief Keep event and device type strings that have no enumeration.
+    /// \param eventType The event type string.
+    /// \param deviceType The device type string.
+    void _preserveCustomTypes(const std::string& eventType,
+                              const std::string& deviceType);
+
     /// \brief The location and orientation of the pointer.
     Point _point;
 
@@ -875,8 +1415,14 @@ private:
     /// \brief The monotonically increasing sequence index for this event.
     uint64_t _sequenceIndex = 0;
 
+    /// \brief The pointer event type.
+    PointerEventType _pointerEventType = PointerEventType::UNKNOWN;
+
     /// \brief The type of device that generated this Point.
-    std::string _deviceType = TYPE_UNKNOWN;
+    PointerDeviceType _pointerDeviceType = PointerDeviceType::UNKNOWN;
+
+    /// \brief The interned device type string.
+    const std::string* _deviceType = &TYPE_UNKNOWN;
 
     /// \brief Indicates if the event was delivered as a coalesced event.
     bool _isCoalesced = false;
@@ -904,17 +1450,21 @@ private:
     /// \brief The current modifiers being pressed.
     uint16_t _modifiers = 0;
 
-    /// \brief Pointer events not delivered since the last frame, including a copy of the current event.
-    std::vector<PointerEventArgs> _coalescedPointerEvents;
+    /// \brief The coalesced samples followed by the predicted samples.
+    ///
+    /// The coalesced samples have not been delivered since the last frame and
+    /// include a copy of the current event. The predicted samples will arrive
+    /// between now and the next frame.
+    PointerSampleBuffer _samples;
 
-    /// \brief Predicted pointer events that will arrive between now and the next frame.
-    std::vector<PointerEventArgs> _predictedPointerEvents;
+    /// \brief The number of coalesced samples at the start of _samples.
+    uint32_t _numCoalescedSamples = 0;
 
-    /// \brief A set of estimated properties.
-    std::set<std::string> _estimatedProperties;
+    /// \brief The estimated properties.
+    PointerPropertyMask _estimatedProperties = POINTER_PROPERTY_NONE;
 
-    /// \param A set of estimated properties that are expecting updates.
-    std::set<std::string> _estimatedPropertiesExpectingUpdates;
+    /// \brief The estimated properties that are expecting updates.
+    PointerPropertyMask _estimatedPropertiesExpectingUpdates = POINTER_PROPERTY_NONE;
 
     friend class PointerEvents;
 
@@ -935,6 +1485,15 @@ inline std::ostream& operator << (std::ostream& os, const PointerEventArgs& e)
 
 inline void to_json(nlohmann::json& j, const PointerEventArgs& v)
 {
+    // Samples are written as complete events for compatibility.
+    nlohmann::json coalesced = nlohmann::json::array();
+    for (const auto& sample: v.coalescedPointerEvents())
+        coalesced.push_back(PointerEventArgs(v, sample));
+
+    nlohmann::json predicted = nlohmann::json::array();
+    for (const auto& sample: v.predictedPointerEvents())
+        predicted.push_back(PointerEventArgs(v, sample));
+
     j =
     {
         { "event_type", v.eventType() },
@@ -952,10 +1511,10 @@ inline void to_json(nlohmann::json& j, const PointerEventArgs& v)
         { "button", v.button() },
         { "buttons", v.buttons() },
         { "modifiers", v.modifiers() },
-        { "coalesced_pointer_events", v.coalescedPointerEvents() },
-        { "predicted_pointer_events", v.predictedPointerEvents() },
-        { "estimated_properties", v.estimatedProperties() },
-        { "estimated_properties_expecting_updates", v.estimatedPropertiesExpectingUpdates() },
+        { "coalesced_pointer_events", coalesced },
+        { "predicted_pointer_events", predicted },
+        { "estimated_properties", toPointerPropertyNames(v.estimatedProperties()) },
+        { "estimated_properties_expecting_updates", toPointerPropertyNames(v.estimatedPropertiesExpectingUpdates()) },
     };
 }
 
@@ -981,25 +1540,190 @@ inline void from_json(const nlohmann::json& j, PointerEventArgs& v)
                          j.value("coalesced_pointer_events", std::vector<PointerEventArgs>()),
                          j.value("predicted_pointer_events", std::vector<PointerEventArgs>()),
                          j.value("estimated_properties", std::set<std::string>()),
-                         j.value("estimated_properties_expecting_updatess", std::set<std::string>()));
+                         j.value("estimated_properties_expecting_updates", std::set<std::string>()));
 }
 
 
-/// \brief A class for converting touch and mouse events into pointer events.
-///
-/// This class is a source of pointer events.  It captures mouse and touch
-/// events from openFrameworks or an external source and repackages and
-/// distributes them as pointer events.
+/// \brief A source of pointer event timestamps.
 ///
-/// This should not be accessed directly.
-class PointerEvents
+/// All timestamps produced by a PointerEvents instance and compared by its
+/// consumers should come from the same PointerClock.
+class PointerClock
 {
 public:
-//    enum EventSource
-//    {
-//        LEGACY_EVENTS,
-//        EXTERNAL_EVENTS
-//    };
+    /// \brief Destroy the PointerClock.
+    virtual ~PointerClock();
+
+    /// \returns the current time in microseconds.
+    virtual uint64_t nowMicros() const = 0;
+
+    /// \brief Convert the age of a platform timestamp to this clock.
+    ///
+    /// Platforms that supply hardware event timestamps in their own time base
+    /// can express them as an age relative to the platform's current time.
+    ///
+    /// \param ageMicros The age of the timestamp in microseconds.
+    /// \returns the timestamp in microseconds in this clock's time base.
+    virtual uint64_t timestampMicrosForAge(uint64_t ageMicros) const;
+
+    /// \returns the shared default clock.
+    static std::shared_ptr<PointerClock> defaultClock();
+
+};
+
+
+/// \brief A PointerClock based on std::chrono::steady_clock.
+class SteadyPointerClock: public PointerClock
+{
+public:
+    /// \brief Create a SteadyPointerClock aligned with ofGetElapsedTimeMicros().
+    SteadyPointerClock();
+
+    /// \brief Create a SteadyPointerClock with the given origin.
+    /// \param origin The time point corresponding to zero microseconds.
+    SteadyPointerClock(std::chrono::steady_clock::time_point origin);
+
+    /// \brief Destroy the SteadyPointerClock.
+    virtual ~SteadyPointerClock();
+
+    uint64_t nowMicros() const override;
+
+    /// \brief Convert a std::chrono::steady_clock time point to this clock.
+    /// \param timePoint The time point to convert.
+    /// \returns the timestamp in microseconds.
+    uint64_t toMicros(std::chrono::steady_clock::time_point timePoint) const;
+
+private:
+    /// \brief The time point corresponding to zero microseconds.
+    std::chrono::steady_clock::time_point _origin;
+
+};
+
+
+/// \brief A PointerClock that only advances when told to.
+///
+/// This is useful for deterministic tests, benchmarks and accelerated replay.
+class ManualPointerClock: public PointerClock
+{
+public:
+    /// \brief Create a ManualPointerClock.
+    /// \param micros The initial time in microseconds.
+    ManualPointerClock(uint64_t micros = 0);
+
+    /// \brief Destroy the ManualPointerClock.
+    virtual ~ManualPointerClock();
+
+    uint64_t nowMicros() const override;
+
+    /// \brief Set the current time.
+    /// \param micros The current time in microseconds.
+    void setMicros(uint64_t micros);
+
+    /// \brief Advance the current time.
+    /// \param micros The number of microseconds to advance.
+    void advanceMicros(uint64_t micros);
+
+private:
+    /// \brief The current time in microseconds.
+    std::atomic<uint64_t> _micros;
+
+};
+
+
+/// \brief The arguments sent once per frame with all of the frame's pointer
+/// events.
+struct PointerFrameArgs: public ofEventArgs
+{
+    /// \brief The timestamp of the frame in microseconds.
+    uint64_t timestampMicros = 0;
+
+    /// \brief All pointer events delivered since the last frame, in order.
+    std::vector<PointerEventArgs> events;
+
+    /// \brief The latest event of every active pointer, ordered by pointer id.
+    ///
+    /// A pointer is active from its first event until its pointerup,
+    /// pointercancel, pointerout or pointerleave event.
+    std::vector<PointerEventArgs> activePointers;
+
+};
+
+
+/// \brief A bounded lock-free queue of pointer events.
+///
+/// Any number of threads may push events concurrently. Only one thread may
+/// pop events at a time. The capacity is rounded up to a power of two.
+class PointerEventQueue
+{
+public:
+    /// \brief Create a PointerEventQueue.
+    /// \param capacity The minimum number of events the queue can hold.
+    PointerEventQueue(std::size_t capacity = 1024);
+
+    /// \brief Destroy the PointerEventQueue.
+    ~PointerEventQueue();
+
+    /// \brief Add an event to the queue.
+    ///
+    /// This may be called from any thread.
+    ///
+    /// \param e The event to add.
+    /// \returns false if the queue is full.
+    bool push(const PointerEventArgs& e);
+
+    /// \brief Remove the oldest event from the queue.
+    ///
+    /// This must only be called from one thread at a time.
+    ///
+    /// \param e The removed event.
+    /// \returns false if the queue is empty.
+    bool pop(PointerEventArgs& e);
+
+    /// \returns the number of events the queue can hold.
+    std::size_t capacity() const;
+
+private:
+    /// \brief A queue slot.
+    struct Cell
+    {
+        /// \brief The slot sequence, used to hand the slot between threads.
+        std::atomic<std::size_t> sequence;
+
+        /// \brief The queued event.
+        PointerEventArgs event;
+
+    };
+
+    /// \brief The queue slots.
+    std::unique_ptr<Cell[]> _cells;
+
+    /// \brief The capacity minus one, used to index the slots.
+    std::size_t _mask = 0;
+
+    /// \brief The next position to push to.
+    alignas(64) std::atomic<std::size_t> _pushPosition;
+
+    /// \brief The next position to pop from.
+    alignas(64) std::atomic<std::size_t> _popPosition;
+
+};
+
+
+/// \brief A class for converting touch and mouse events into pointer events.
+///
+/// This class is a source of pointer events.  It captures mouse and touch
+/// events from openFrameworks or an external source and repackages and
+/// distributes them as pointer events.
+///
+/// This should not be accessed directly.
+class PointerEvents
+{
+public:
+//    enum EventSource
+//    {
+//        LEGACY_EVENTS,
+//        EXTERNAL_EVENTS
+//    };
 
     /// \brief Create a PointerEvents object with the given source.
     /// \param source The window that will provide the events.
@@ -1026,6 +1750,108 @@ public:
     /// \returns true of the event was handled.
     bool onTouchEvent(const void* source, ofTouchEventArgs& e);
 
+    /// \brief Key event callback.
+    ///
+    /// Key events are used to track the modifier keys and are never consumed.
+    ///
+    /// \param source The event source.
+    /// \param e the event arguments.
+    /// \returns false.
+    bool onKeyEvent(const void* source, ofKeyEventArgs& e);
+
+    /// \brief Update event callback.
+    ///
+    /// Delivers any coalesced pointer moves once per frame.
+    ///
+    /// \param e the event arguments.
+    void onUpdate(ofEventArgs& e);
+
+    /// \brief Enable or disable coalescing of pointer moves.
+    ///
+    /// When enabled, pointer moves are buffered per pointer and delivered once
+    /// per frame as a single pointermove. The delivered event's
+    /// coalescedPointerEvents() contains all buffered samples, including the
+    /// current event. Buffered moves for a pointer are delivered before any
+    /// other event for that pointer. Disabled by default.
+    ///
+    /// \param coalesceMoves True if pointer moves should be coalesced.
+    void setCoalesceMoves(bool coalesceMoves);
+
+    /// \returns true if pointer moves are coalesced.
+    bool getCoalesceMoves() const;
+
+    /// \brief Deliver all buffered pointer moves immediately.
+    void flushCoalescedMoves();
+
+    /// \brief Queue a pointer event to be dispatched on the main thread.
+    ///
+    /// This may be called from any thread. Queued events are dispatched by
+    /// drain(). If the queue is full, the event is dropped and counted by
+    /// numDroppedEvents().
+    ///
+    /// \param e The event to queue.
+    /// \returns true if the event was queued.
+    bool enqueuePointerEvent(const PointerEventArgs& e);
+
+    /// \brief Dispatch all queued pointer events.
+    ///
+    /// This must be called from the main thread. If auto drain is enabled, it
+    /// is called automatically before each update.
+    ///
+    /// \returns the number of events dispatched.
+    std::size_t drain();
+
+    /// \brief Enable or disable draining the queue before each update.
+    ///
+    /// Enabled by default.
+    ///
+    /// \param autoDrain True if the queue should be drained automatically.
+    void setAutoDrain(bool autoDrain);
+
+    /// \returns true if the queue is drained before each update.
+    bool getAutoDrain() const;
+
+    /// \brief Set the capacity of the event queue.
+    ///
+    /// This has no effect after the first event has been queued.
+    ///
+    /// \param capacity The minimum number of events the queue can hold.
+    void setQueueCapacity(std::size_t capacity);
+
+    /// \returns the total number of events queued.
+    uint64_t numEnqueuedEvents() const;
+
+    /// \returns the total number of events dropped because the queue was full.
+    uint64_t numDroppedEvents() const;
+
+    /// \brief Set the predictor used to generate predicted samples.
+    ///
+    /// When set, the predictor is updated with every delivered pointer event
+    /// and adds predicted samples to pointer moves that do not already have
+    /// platform-supplied predictions. Set to nullptr to disable prediction.
+    ///
+    /// \param predictor The predictor to set.
+    void setPredictor(std::shared_ptr<PointerPredictor> predictor);
+
+    /// \returns the predictor or nullptr if prediction is disabled.
+    std::shared_ptr<PointerPredictor> getPredictor() const;
+
+    /// \returns the modifier keys currently pressed, e.g. OF_KEY_SHIFT.
+    uint16_t modifiers() const;
+
+    /// \returns the mouse buttons currently pressed, e.g. (1 << OF_MOUSE_BUTTON_1).
+    uint16_t buttons() const;
+
+    /// \brief Set the clock used to timestamp events.
+    ///
+    /// If clock is nullptr, the PointerClock::defaultClock() is used.
+    ///
+    /// \param clock The clock to set.
+    void setClock(std::shared_ptr<PointerClock> clock);
+
+    /// \returns the clock used to timestamp events.
+    std::shared_ptr<PointerClock> clock() const;
+
 //    /// \brief Disable legacy mouse / touch events.
 //    ///
 //    /// If legacy mouse / touch events are disabled, they will be automatically
@@ -1124,6 +1950,13 @@ public:
     ///     touches it with a third finger, this event is raised.
     ofEvent<PointerEventArgs> pointerCancel;
 
+    /// \brief Event that is triggered once per frame with all pointer events.
+    ///
+    /// Triggered before the app's update if any pointer events were delivered
+    /// since the last frame or any pointers are active. Events are only
+    /// collected while this event has listeners.
+    ofEvent<PointerFrameArgs> pointerFrame;
+
     /// \brief Event that is triggered when a point has been updated.
     ///
     /// This event can be called in systems that offer updates to estimated
@@ -1142,6 +1975,28 @@ protected:
     /// \returns true of the event was handled.
     bool _dispatchPointerEvent(const void* source, PointerEventArgs& e);
 
+    /// \brief Notify the pointer event listeners.
+    /// \param e the event arguments.
+    /// \returns true of the event was consumed.
+    bool _notifyPointerEvent(PointerEventArgs& e);
+
+    /// \brief Buffer a pointer move, merging it with any buffered move.
+    /// \param e the pointer move to buffer.
+    void _coalesceMove(const PointerEventArgs& e);
+
+    /// \brief Deliver the buffered pointer move for the given pointer, if any.
+    /// \param pointerId The pointer id.
+    void _flushCoalescedMove(std::size_t pointerId);
+
+    /// \brief The number of PointerEventType values.
+    static constexpr std::size_t NUM_POINTER_EVENT_TYPES = static_cast<std::size_t>(PointerEventType::LOST_POINTER_CAPTURE) + 1;
+
+    /// \brief The typed events indexed by PointerEventType.
+    ///
+    /// Entries are nullptr for event types that are only delivered via
+    /// pointerEvent.
+    std::array<ofEvent<PointerEventArgs>*, NUM_POINTER_EVENT_TYPES> _eventsForType;
+
     /// \brief True if the PointerEvents should consume mouse / touch events.
     bool _consumeLegacyEvents = false;
 
@@ -1186,6 +2041,65 @@ protected:
     /// \brief Touch cancelled event listener.
     ofEventListener _touchCancelledListener;
 
+    /// \brief Update event listener.
+    ofEventListener _updateListener;
+
+    /// \brief True if pointer moves are coalesced.
+    bool _coalesceMoves = false;
+
+    /// \brief Buffered pointer moves by pointer id.
+    std::map<std::size_t, PointerEventArgs> _pendingMoves;
+
+    /// \brief The predictor used to generate predicted samples.
+    std::shared_ptr<PointerPredictor> _predictor;
+
+    /// \brief Deliver the pointerFrame event and reset the frame.
+    void _notifyPointerFrame();
+
+    /// \brief The frame being collected.
+    PointerFrameArgs _frame;
+
+    /// \brief The latest event of every active pointer by pointer id.
+    std::map<std::size_t, PointerEventArgs> _activePointers;
+
+    /// \brief Guards the creation of the event queue.
+    std::once_flag _queueOnceFlag;
+
+    /// \brief The event queue, created when the first event is queued.
+    std::unique_ptr<PointerEventQueue> _queue;
+
+    /// \brief The minimum capacity of the event queue.
+    std::size_t _queueCapacity = 1024;
+
+    /// \brief True if the queue is drained before each update.
+    bool _autoDrain = true;
+
+    /// \brief The total number of events queued.
+    std::atomic<uint64_t> _numEnqueuedEvents { 0 };
+
+    /// \brief The total number of events dropped because the queue was full.
+    std::atomic<uint64_t> _numDroppedEvents { 0 };
+
+    /// \brief Key pressed event listener.
+    ofEventListener _keyPressedListener;
+
+    /// \brief Key released event listener.
+    ofEventListener _keyReleasedListener;
+
+    /// \brief The left and right modifier keys currently pressed.
+    ///
+    /// Each bit corresponds to a left or right modifier key.
+    uint8_t _modifierKeys = 0;
+
+    /// \brief The modifier keys currently pressed.
+    uint16_t _modifiers = 0;
+
+    /// \brief The mouse buttons currently pressed.
+    uint16_t _buttons = 0;
+
+    /// \brief The clock used to timestamp events.
+    std::shared_ptr<PointerClock> _clock;
+
     /// \brief The default source if the callback is missing.
     ofAppBaseWindow* _source = nullptr;
 
@@ -1332,6 +2246,75 @@ void UnregisterPointerEvent(ListenerClass* listener, int prio = OF_EVENT_ORDER_A
 }
 
 
+/// \brief The per-sample values of a stroke stored as parallel arrays.
+///
+/// Each array holds one value per sample in the same order as the stroke's
+/// events, so loops that only need a few values, like smoothing and
+/// tessellation, can iterate over contiguous memory. The arrays can also be
+/// uploaded directly to vertex buffers.
+class PointerStrokeData
+{
+public:
+    /// \brief Add the values of an event.
+    /// \param e The event to add.
+    void add(const PointerEventArgs& e);
+
+    /// \brief Replace the values at the given index with those of an event.
+    /// \param index The sample index.
+    /// \param e The event to copy values from.
+    void set(std::size_t index, const PointerEventArgs& e);
+
+    /// \brief Resize all arrays, removing samples from the end.
+    /// \param size The new number of samples.
+    void resize(std::size_t size);
+
+    /// \brief Reserve space in all arrays.
+    /// \param size The number of samples to reserve space for.
+    void reserve(std::size_t size);
+
+    /// \brief Remove all samples.
+    void clear();
+
+    /// \returns the number of samples.
+    std::size_t size() const;
+
+    /// \returns true if size() == 0.
+    bool empty() const;
+
+    /// \returns the positions in screen coordinates.
+    const std::vector<glm::vec2>& positions() const;
+
+    /// \returns the normalized pressures.
+    const std::vector<float>& pressures() const;
+
+    /// \returns the tilt x and tilt y angles in degrees.
+    const std::vector<glm::vec2>& tiltsDeg() const;
+
+    /// \returns the timestamps in microseconds.
+    const std::vector<uint64_t>& timestampsMicros() const;
+
+    /// \returns the PointerSample::Flags of each sample.
+    const std::vector<uint8_t>& flags() const;
+
+private:
+    /// \brief The positions in screen coordinates.
+    std::vector<glm::vec2> _positions;
+
+    /// \brief The normalized pressures.
+    std::vector<float> _pressures;
+
+    /// \brief The tilt x and tilt y angles in degrees.
+    std::vector<glm::vec2> _tiltsDeg;
+
+    /// \brief The timestamps in microseconds.
+    std::vector<uint64_t> _timestampsMicros;
+
+    /// \brief The PointerSample::Flags of each sample.
+    std::vector<uint8_t> _flags;
+
+};
+
+
 /// \brief A PointerStroke is a collection of events with the same pointer id.
 ///
 /// A pointer stroke begins with a pointerdown event and ends with a pointerup
@@ -1382,7 +2365,88 @@ public:
     /// \returns the events.
     const std::vector<PointerEventArgs>& events() const;
 
+    /// \brief Get the values of the events as parallel arrays.
+    ///
+    /// The data has one sample per event in the same order as events().
+    ///
+    /// \returns the stroke data.
+    const PointerStrokeData& data() const;
+
+    /// \brief Get the number of predicted events.
+    ///
+    /// Predicted events are always at the end of events() and are replaced
+    /// when the next event is added.
+    ///
+    /// \returns the number of predicted events.
+    std::size_t numPredictedEvents() const;
+
+    /// \brief Get the index of the first event changed by the last call to add().
+    ///
+    /// The events changed by the last successful call to add() are the range
+    /// [modifiedIndex(), modifiedIndex() + numModifiedEvents()). Adding an
+    /// event changes every event from the old predicted tail to the end.
+    /// Updating an event's estimated properties changes only that event.
+    ///
+    /// \returns the index of the first changed event.
+    std::size_t modifiedIndex() const;
+
+    /// \returns the number of events changed by the last call to add().
+    std::size_t numModifiedEvents() const;
+
+    /// \brief Get the bounding box of the measured events.
+    ///
+    /// Like the other stroke statistics, this is maintained as events are
+    /// added and updated and excludes predicted events.
+    ///
+    /// \returns the bounding box in screen coordinates.
+    ofRectangle boundingBox() const;
+
+    /// \returns the path length of the measured events in pixels.
+    double arcLength() const;
+
+    /// Timestamps are not required to increase, so this is the time between
+    /// the earliest and latest measured events.
+    ///
+    /// \returns the time between the earliest and latest measured events in microseconds.
+    uint64_t durationMicros() const;
+
+    /// \returns the arc length divided by the duration in pixels per second.
+    double averageSpeed() const;
+
+    /// \returns the minimum pressure of the measured events.
+    float minPressure() const;
+
+    /// \returns the maximum pressure of the measured events.
+    float maxPressure() const;
+
+    /// \brief An event that is called when a stored event's estimated
+    /// properties are updated.
+    ofEvent<PointerPropertyUpdateEventArgs> pointerPropertyUpdate;
+
 private:
+    /// \brief Add a measured event, indexing it if it expects updates.
+    /// \param e The event to add.
+    void _addMeasured(const PointerEventArgs& e);
+
+    /// \brief Update the statistics before an event's values are replaced.
+    /// \param index The index of the updated event.
+    /// \param e The updated event.
+    void _updateStatistics(std::size_t index, const PointerEventArgs& e);
+
+    /// \brief Expand the extrema to include the given values.
+    /// \param position The position to include.
+    /// \param pressure The pressure to include.
+    /// \param timestampMicros The timestamp to include.
+    void _expandExtrema(const glm::vec2& position,
+                        float pressure,
+                        uint64_t timestampMicros) const;
+
+    /// \brief Recompute the extrema if an update invalidated them.
+    void _validateExtrema() const;
+
+    /// \returns the number of events that are not predicted.
+    std::size_t _numMeasuredEvents() const;
+
     /// \brief The pointer id of all events in this stroke.
     std::size_t _pointerId = -1;
 
@@ -1395,6 +2459,50 @@ private:
     /// \brief All events associated with this stroke.
     std::vector<PointerEventArgs> _events;
 
+    /// \brief The values of _events as parallel arrays.
+    PointerStrokeData _data;
+
+    /// \brief The number of predicted events at the end of _events.
+    std::size_t _numPredictedEvents = 0;
+
+    /// \brief The number of events expecting updates.
+    std::size_t _numExpectingUpdates = 0;
+
+    /// \brief The index in _events of each event expecting updates by sequence index.
+    std::unordered_map<uint64_t, std::size_t> _pendingUpdates;
+
+    /// \brief The index of the first event changed by the last call to add().
+    std::size_t _modifiedIndex = 0;
+
+    /// \brief The number of events changed by the last call to add().
+    std::size_t _numModifiedEvents = 0;
+
+    /// \brief The path length of the measured events in pixels.
+    double _arcLength = 0;
+
+    /// \brief The minimum measured position.
+    mutable glm::vec2 _minPosition = glm::vec2(std::numeric_limits<float>::max());
+
+    /// \brief The maximum measured position.
+    mutable glm::vec2 _maxPosition = glm::vec2(std::numeric_limits<float>::lowest());
+
+    /// \brief The minimum measured pressure.
+    mutable float _minPressure = std::numeric_limits<float>::max();
+
+    /// \brief The maximum measured pressure.
+    mutable float _maxPressure = std::numeric_limits<float>::lowest();
+
+    /// \brief The earliest measured timestamp in microseconds.
+    mutable uint64_t _minTimestampMicros = std::numeric_limits<uint64_t>::max();
+
+    /// \brief The latest measured timestamp in microseconds.
+    mutable uint64_t _maxTimestampMicros = 0;
+
+    /// \brief True if an update moved a value off of the extrema.
+    ///
+    /// Updates can shrink the extrema, so they are recomputed when next needed.
+    mutable bool _extremaInvalid = false;
+
 };
 
 
@@ -1420,10 +2528,16 @@ public:
 
     /// \brief Update the strokes.
     ///
-    /// This will remove strokes that have timed out.
+    /// This will remove strokes that have timed out. Strokes are expired
+    /// from a queue ordered by time, so only pointers with an expiring stroke
+    /// are visited.
     void update();
 
     /// \brief Draw the strokes.
+    ///
+    /// All strokes are joined with degenerate triangles into a single
+    /// triangle strip, which is drawn with one draw call. The strip is only
+    /// rebuilt when strokes have changed.
     void draw() const;
 
     void draw(const PointerStroke& stroke) const;
@@ -1441,6 +2555,12 @@ public:
     // \returns the stroke map.
     const std::map<std::size_t, std::vector<PointerStroke>>& strokes() const;
 
+    /// \returns the number of vertices submitted by the last call to draw().
+    std::size_t numVertices() const;
+
+    /// \returns the number of draw calls made by the last call to draw().
+    std::size_t numBatches() const;
+
     struct Settings
     {
         Settings();
@@ -1460,28 +2580,290 @@ public:
         /// \brief The color of predicted points.
         ofColor predictedPointColor;
 
+        /// \brief The clock used to expire and fade strokes.
+        ///
+        /// This should be the clock used to timestamp the events.
+        std::shared_ptr<PointerClock> clock;
+
+    };
+
+    /// \brief The tessellated geometry of a single stroke.
+    ///
+    /// Each event is tessellated into a pair of triangle strip vertices. Only
+    /// changed events and their neighbours are tessellated again, and fading
+    /// only rewrites the colors of events whose age changes their opacity.
+    /// The geometry is kept in an ofMesh on the CPU, so it can be built and
+    /// inspected without a GL context.
+    class StrokeMesh
+    {
+    public:
+        /// \brief Tessellate the changed events of a stroke.
+        ///
+        /// Events outside of [first, last) are assumed to be unchanged, but
+        /// the stroke may have grown or shrunk since the last tessellation.
+        ///
+        /// \param stroke The stroke to tessellate.
+        /// \param settings The settings to tessellate with.
+        /// \param first The index of the first changed event.
+        /// \param last One past the index of the last changed event.
+        void tessellate(const PointerStroke& stroke,
+                        const Settings& settings,
+                        std::size_t first,
+                        std::size_t last);
+
+        /// \brief Tessellate all events of a stroke.
+        /// \param stroke The stroke to tessellate.
+        /// \param settings The settings to tessellate with.
+        void tessellate(const PointerStroke& stroke, const Settings& settings);
+
+        /// \brief Fade the events by age.
+        ///
+        /// Events are expected to be in timestamp order. Events older than
+        /// lastValidTimeMicros are transparent and events within
+        /// fadeTimeMicros of it are partially faded.
+        ///
+        /// \param lastValidTimeMicros The timestamp of a fully faded event.
+        /// \param fadeTimeMicros The duration of the fade.
+        /// \returns true if any colors were changed.
+        bool fade(uint64_t lastValidTimeMicros, uint64_t fadeTimeMicros);
+
+        /// \returns the triangle strip mesh.
+        const ofMesh& mesh() const;
+
+        /// \returns the number of events tessellated by the last call to tessellate().
+        std::size_t numTessellatedEvents() const;
+
+    private:
+        /// \brief The color properties of a tessellated event.
+        struct Sample
+        {
+            /// \brief The color of the event before fading.
+            ofColor color;
+
+            /// \brief The normalized pressure of the event.
+            float pressure = 0;
+
+            /// \brief True if the event fades by age and pressure.
+            bool isFaded = true;
+
+            /// \brief The timestamp of the event in microseconds.
+            uint64_t timestampMicros = 0;
+
+        };
+
+        /// \brief Tessellate a single event.
+        /// \param events The events of the stroke.
+        /// \param settings The settings to tessellate with.
+        /// \param i The index of the event.
+        void _tessellate(const std::vector<PointerEventArgs>& events,
+                         const Settings& settings,
+                         std::size_t i);
+
+        /// \brief Set the vertex colors of a single event.
+        /// \param i The index of the event.
+        void _color(std::size_t i);
+
+        /// \brief The triangle strip mesh with two vertices per event.
+        ofMesh _mesh;
+
+        /// \brief The color properties of each event.
+        std::vector<Sample> _samples;
+
+        /// \brief The number of events at the start of the stroke that are transparent.
+        std::size_t _numFadedEvents = 0;
+
+        /// \brief The timestamp of a fully faded event.
+        uint64_t _lastValidTimeMicros = 0;
+
+        /// \brief The duration of the fade.
+        uint64_t _fadeTimeMicros = 0;
+
+        /// \brief The number of events tessellated by the last call to tessellate().
+        std::size_t _numTessellatedEvents = 0;
+
     };
 
 private:
+    /// \returns the current time of the Settings clock in milliseconds.
+    uint64_t _nowMillis() const;
+
+    /// \brief Fade the stroke meshes.
+    void _fade();
+
+    /// \brief Rebuild the batched mesh if any stroke meshes have changed.
+    void _updateBatch() const;
+
+    /// \returns the timestamp of the stroke's last event in milliseconds or 0 if empty.
+    static uint64_t _lastTimestampMillis(const PointerStroke& stroke);
+
+    /// \brief An entry in the expiry queue.
+    struct Expiry
+    {
+        /// \brief The timestamp of the pointer's first stroke when queued.
+        uint64_t timestampMillis = 0;
+
+        /// \brief The pointer id.
+        std::size_t pointerId = 0;
+
+        /// \brief Order entries so the earliest is at the top of the queue.
+        bool operator > (const Expiry& other) const
+        {
+            return timestampMillis > other.timestampMillis;
+        }
+
+    };
+
     /// \brief The Settings.
     Settings _settings;
 
     /// \brief A map of strokes.
     std::map<std::size_t, std::vector<PointerStroke>> _strokes;
 
+    /// \brief The meshes of the strokes in _strokes, in the same order.
+    std::map<std::size_t, std::vector<StrokeMesh>> _meshes;
+
+    /// \brief The pointers with strokes ordered by the last timestamp of their first stroke.
+    ///
+    /// The queue has one entry for each pointer in _strokes. An entry's
+    /// timestamp may be older than its stroke's, in which case it is queued
+    /// again when it reaches the top.
+    std::priority_queue<Expiry, std::vector<Expiry>, std::greater<Expiry>> _expiryQueue;
+
+    /// \brief The last valid time used to fade the strokes in milliseconds.
+    uint64_t _lastValidTimeMillis = 0;
+
+    /// \brief The fade time used to fade the strokes in milliseconds.
+    uint64_t _fadeTimeMillis = 0;
+
+    /// \brief All stroke meshes joined into a single triangle strip.
+    mutable ofVboMesh _batch;
+
+    /// \brief True if the stroke meshes have changed since the batch was built.
+    mutable bool _batchInvalid = true;
+
+    /// \brief The number of vertices submitted by the last call to draw().
+    mutable std::size_t _numVertices = 0;
+
+    /// \brief The number of draw calls made by the last call to draw().
+    mutable std::size_t _numBatches = 0;
+
 };
 
 
 /// \brief A class for organiaing and querying collections of pointers.
+///
+/// Events are stored in fixed-size chunks that never move, so pointers to
+/// stored events remain valid until the events are removed. Each event is
+/// linked into a list of all events and a list of its pointer's events, both
+/// in order of addition.
+///
+/// Events are expected to be added in timestamp order. Time range queries
+/// binary search a timestamp index. An event with an earlier timestamp than a
+/// previously added event is indexed at the latest timestamp seen so far.
 class PointerEventCollection
 {
 public:
     /// \brief Create an empty PointerEventCollection.
     PointerEventCollection();
 
+    /// \brief Create a copy of a PointerEventCollection.
+    /// \param other The collection to copy.
+    PointerEventCollection(const PointerEventCollection& other);
+
     /// \brief Destroy the PointerEventCollection.
     virtual ~PointerEventCollection();
 
+    /// \brief Replace the contents with a copy of another PointerEventCollection.
+    /// \param other The collection to copy.
+    /// \returns a reference to this collection.
+    PointerEventCollection& operator = (const PointerEventCollection& other);
+
+    class EventRange;
+
+    /// \brief A forward iterator over stored events.
+    ///
+    /// Iterators remain valid until the event they refer to is removed.
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef PointerEventArgs value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const PointerEventArgs* pointer;
+        typedef const PointerEventArgs& reference;
+
+        /// \brief Create an invalid iterator.
+        const_iterator();
+
+        reference operator * () const;
+        pointer operator -> () const;
+        const_iterator& operator ++ ();
+        const_iterator operator ++ (int);
+        bool operator == (const const_iterator& other) const;
+        bool operator != (const const_iterator& other) const;
+
+    private:
+        /// \brief Create an iterator.
+        /// \param collection The collection.
+        /// \param index The node index or NPOS for the end.
+        /// \param pointerOnly True if iterating over a single pointer's events.
+        const_iterator(const PointerEventCollection* collection,
+                       std::size_t index,
+                       bool pointerOnly);
+
+        /// \brief The collection.
+        const PointerEventCollection* _collection = nullptr;
+
+        /// \brief The node index or NPOS for the end.
+        std::size_t _index = NPOS;
+
+        /// \brief True if iterating over a single pointer's events.
+        bool _pointerOnly = false;
+
+        friend class PointerEventCollection;
+        friend class EventRange;
+
+    };
+
+    /// \brief A view of a range of stored events in order of addition.
+    ///
+    /// A range does not copy events. It remains valid until the collection is
+    /// modified.
+    class EventRange
+    {
+    public:
+        /// \brief Create an empty EventRange.
+        EventRange();
+
+        /// \returns an iterator to the first event.
+        const_iterator begin() const;
+
+        /// \returns an iterator past the last event.
+        const_iterator end() const;
+
+        /// \returns true if the range has no events.
+        bool empty() const;
+
+        /// \brief Count the events in the range. This is O(k).
+        /// \returns the number of events.
+        std::size_t size() const;
+
+    private:
+        /// \brief Create an EventRange.
+        /// \param begin The first event.
+        /// \param end The iterator past the last event.
+        EventRange(const_iterator begin, const_iterator end);
+
+        /// \brief The first event.
+        const_iterator _begin;
+
+        /// \brief The iterator past the last event.
+        const_iterator _end;
+
+        friend class PointerEventCollection;
+
+    };
+
     /// \returns the number of events in the collection.
     std::size_t size() const;
 
@@ -1507,14 +2889,79 @@ public:
     /// \param pointerId The pointer events to remove.
     void removeEventsForPointerId(std::size_t pointerId);
 
+    /// \brief Remove all events older than the given timestamp.
+    ///
+    /// This is O(k) in the number of events removed.
+    ///
+    /// \param timestampMicros The timestamp of the oldest event to keep.
+    void removeEventsBefore(uint64_t timestampMicros);
+
+    /// \brief Set the amount of history to retain.
+    ///
+    /// When adding an event, events older than the newest event's timestamp
+    /// minus the retention are removed. A retention of zero keeps all events.
+    ///
+    /// \param retentionMicros The retention in microseconds.
+    void setRetentionMicros(uint64_t retentionMicros);
+
+    /// \returns the amount of history to retain in microseconds.
+    uint64_t getRetentionMicros() const;
+
+    /// \returns a view of all pointer events in the collection.
+    EventRange eventRange() const;
+
+    /// \brief Get a view of the pointer events in a time range.
+    ///
+    /// This is O(log n) plus the cost of iterating the view.
+    ///
+    /// \param minTimestampMicros The minimum timestamp, inclusive.
+    /// \param maxTimestampMicros The maximum timestamp, inclusive.
+    /// \returns a view of the pointer events in the time range.
+    EventRange eventRange(uint64_t minTimestampMicros,
+                          uint64_t maxTimestampMicros) const;
+
+    /// \brief Get a view of the pointer events for a given pointer id.
+    /// \param pointerId The pointer id to query.
+    /// \returns a view of the pointer events or an empty view if none.
+    EventRange eventRangeForPointerId(std::size_t pointerId) const;
+
+    /// \brief Get a view of the pointer events for a given pointer id in a
+    /// time range.
+    ///
+    /// This is O(log k) plus the cost of iterating the view.
+    ///
+    /// \param pointerId The pointer id to query.
+    /// \param minTimestampMicros The minimum timestamp, inclusive.
+    /// \param maxTimestampMicros The maximum timestamp, inclusive.
+    /// \returns a view of the pointer events or an empty view if none.
+    EventRange eventRangeForPointerId(std::size_t pointerId,
+                                      uint64_t minTimestampMicros,
+                                      uint64_t maxTimestampMicros) const;
+
     /// \returns all pointer events in the collection.
     std::vector<PointerEventArgs> events() const;
 
+    /// \brief Get the pointer events in a time range.
+    /// \param minTimestampMicros The minimum timestamp, inclusive.
+    /// \param maxTimestampMicros The maximum timestamp, inclusive.
+    /// \returns the pointer events in the time range.
+    std::vector<PointerEventArgs> events(uint64_t minTimestampMicros,
+                                         uint64_t maxTimestampMicros) const;
+
     /// \brief Get the pointer events for a given key.
     /// \param pointerId The pointer id to query.
     /// \returns the pointer events for the given key or an empty set if none.
     std::vector<PointerEventArgs> eventsForPointerId(std::size_t pointerId) const;
 
+    /// \brief Get the pointer events for a given key in a time range.
+    /// \param pointerId The pointer id to query.
+    /// \param minTimestampMicros The minimum timestamp, inclusive.
+    /// \param maxTimestampMicros The maximum timestamp, inclusive.
+    /// \returns the pointer events for the given key or an empty set if none.
+    std::vector<PointerEventArgs> eventsForPointerId(std::size_t pointerId,
+                                                     uint64_t minTimestampMicros,
+                                                     uint64_t maxTimestampMicros) const;
+
     /// \brief Get a pointer to the first event for a given pointer id.
     /// \param pointerId The pointer id to query.
     /// \returns a const pointer to the first event or nullptr if none.
@@ -1526,11 +2973,396 @@ public:
     const PointerEventArgs* lastEventForPointerId(std::size_t pointerId) const;
 
 private:
-    /// \brief The set of pointer events in order of addition.
-    std::vector<PointerEventArgs> _events;
+    /// \brief An invalid node index.
+    static constexpr std::size_t NPOS = std::numeric_limits<std::size_t>::max();
+
+    /// \brief The number of nodes in each chunk.
+    static constexpr std::size_t CHUNK_SIZE = 256;
+
+    /// \brief A stored event and its list links.
+    struct Node
+    {
+        /// \brief The stored event.
+        PointerEventArgs event;
+
+        /// \brief The previous node in the list of all events.
+        std::size_t previous = NPOS;
+
+        /// \brief The next node in the list of all events or the free list.
+        std::size_t next = NPOS;
+
+        /// \brief The previous node in the list of the pointer's events.
+        std::size_t pointerPrevious = NPOS;
+
+        /// \brief The next node in the list of the pointer's events.
+        std::size_t pointerNext = NPOS;
+
+        /// \brief The timestamp used by the time index.
+        uint64_t indexTimestampMicros = 0;
+
+        /// \brief Incremented each time the node is released.
+        uint64_t generation = 0;
+
+    };
+
+    /// \brief An entry in a time index.
+    struct IndexEntry
+    {
+        /// \brief The timestamp used by the time index.
+        uint64_t timestampMicros = 0;
+
+        /// \brief The node index.
+        std::size_t index = NPOS;
+
+        /// \brief The node generation when the entry was added.
+        uint64_t generation = 0;
+
+    };
+
+    /// \brief The list of a single pointer's events.
+    struct PointerList
+    {
+        /// \brief The first node.
+        std::size_t first = NPOS;
+
+        /// \brief The last node.
+        std::size_t last = NPOS;
+
+        /// \brief The number of nodes.
+        std::size_t size = 0;
+
+        /// \brief The time index of the pointer's nodes.
+        std::deque<IndexEntry> timeIndex;
+
+    };
+
+    /// \returns the node with the given index.
+    Node& _node(std::size_t index);
+
+    /// \returns the node with the given index.
+    const Node& _node(std::size_t index) const;
+
+    /// \brief Store an event in a free node, allocating a chunk if needed.
+    /// \param pointerEvent The event to store.
+    /// \returns the index of the node.
+    std::size_t _allocate(const PointerEventArgs& pointerEvent);
+
+    /// \brief Return an unlinked node to the free list.
+    /// \param index The index of the node.
+    void _release(std::size_t index);
+
+    /// \brief Remove the oldest event.
+    void _removeFirst();
+
+    /// \brief Find the first live node at or after a position in the time index.
+    /// \param position The position in _timeIndex.
+    /// \returns the node index or NPOS if none.
+    std::size_t _liveIndexAt(std::size_t position) const;
+
+    /// \brief Rebuild the time index without entries for removed events.
+    void _compactTimeIndex();
+
+    /// \brief The node storage.
+    std::vector<std::unique_ptr<Node[]>> _chunks;
+
+    /// \brief The number of nodes that have ever been allocated.
+    std::size_t _numNodes = 0;
+
+    /// \brief The first node in the free list.
+    std::size_t _free = NPOS;
+
+    /// \brief The first node in the list of all events.
+    std::size_t _first = NPOS;
+
+    /// \brief The last node in the list of all events.
+    std::size_t _last = NPOS;
+
+    /// \brief The number of stored events.
+    std::size_t _size = 0;
+
+    /// \brief The lists of events by pointer id.
+    std::unordered_map<std::size_t, PointerList> _pointers;
+
+    /// \brief The time index of all nodes, possibly including removed nodes.
+    std::deque<IndexEntry> _timeIndex;
+
+    /// \brief The number of entries in _timeIndex for removed nodes.
+    std::size_t _numStaleIndexEntries = 0;
+
+    /// \brief The latest timestamp added.
+    uint64_t _maxTimestampMicros = 0;
+
+    /// \brief The amount of history to retain or zero to keep all events.
+    uint64_t _retentionMicros = 0;
+
+};
+
+
+/// \brief A fixed-capacity history of pointer events.
+///
+/// The event slots, the pointer table and storage for samplesPerEvent
+/// coalesced and predicted samples per event are allocated on construction.
+/// When the ring is full, adding an event overwrites the oldest event. Adding
+/// an event with more than samplesPerEvent samples grows the storage of the
+/// slot it is written to. Each event is linked into a list of its pointer's
+/// events, so per-pointer queries do not scan the whole ring.
+class PointerHistoryRing
+{
+public:
+    /// \brief The default number of samples stored per event without allocating.
+    ///
+    /// This holds an event's copy of itself, one coalesced sample and the
+    /// default number of predicted samples.
+    static constexpr std::size_t DEFAULT_SAMPLES_PER_EVENT = 4;
+
+    class EventRange;
+
+    /// \brief A forward iterator over events in the ring.
+    ///
+    /// Iterators are invalidated when the event they refer to is overwritten.
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef PointerEventArgs value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const PointerEventArgs* pointer;
+        typedef const PointerEventArgs& reference;
+
+        /// \brief Create an invalid iterator.
+        const_iterator();
+
+        reference operator * () const;
+        pointer operator -> () const;
+        const_iterator& operator ++ ();
+        const_iterator operator ++ (int);
+        bool operator == (const const_iterator& other) const;
+        bool operator != (const const_iterator& other) const;
+
+    private:
+        /// \brief Create an iterator.
+        /// \param ring The ring.
+        /// \param index The slot index or NPOS for the end.
+        /// \param pointerOnly True if iterating over a single pointer's events.
+        const_iterator(const PointerHistoryRing* ring,
+                       std::size_t index,
+                       bool pointerOnly);
+
+        /// \brief The ring.
+        const PointerHistoryRing* _ring = nullptr;
+
+        /// \brief The slot index or NPOS for the end.
+        std::size_t _index = NPOS;
+
+        /// \brief True if iterating over a single pointer's events.
+        bool _pointerOnly = false;
+
+        friend class PointerHistoryRing;
+
+    };
+
+    /// \brief A view of a range of events in the ring, oldest first.
+    ///
+    /// A range does not copy events. It remains valid until the ring is
+    /// modified.
+    class EventRange
+    {
+    public:
+        /// \brief Create an empty EventRange.
+        EventRange();
+
+        /// \returns an iterator to the first event.
+        const_iterator begin() const;
+
+        /// \returns an iterator past the last event.
+        const_iterator end() const;
+
+        /// \returns true if the range has no events.
+        bool empty() const;
+
+    private:
+        /// \brief Create an EventRange.
+        /// \param begin The first event.
+        EventRange(const_iterator begin);
+
+        /// \brief The first event.
+        const_iterator _begin;
+
+        friend class PointerHistoryRing;
+
+    };
+
+    /// \brief Create a PointerHistoryRing.
+    /// \param capacity The maximum number of events.
+    /// \param samplesPerEvent The number of samples stored per event without allocating.
+    PointerHistoryRing(std::size_t capacity,
+                       std::size_t samplesPerEvent = DEFAULT_SAMPLES_PER_EVENT);
+
+    /// \brief Destroy the PointerHistoryRing.
+    virtual ~PointerHistoryRing();
+
+    /// \brief Calculate the capacity that fits in a memory budget.
+    ///
+    /// The budget covers the event slots, the pointer table and the sample
+    /// storage allocated on construction.
+    ///
+    /// \param bytes The memory budget in bytes.
+    /// \param samplesPerEvent The number of samples stored per event without allocating.
+    /// \returns the capacity in events.
+    static std::size_t capacityForBytes(std::size_t bytes,
+                                        std::size_t samplesPerEvent = DEFAULT_SAMPLES_PER_EVENT);
+
+    /// \returns the number of samples stored per event without allocating.
+    std::size_t samplesPerEvent() const;
+
+    /// \returns the number of events in the ring.
+    std::size_t size() const;
+
+    /// \returns the maximum number of events in the ring.
+    std::size_t capacity() const;
+
+    /// \returns true if the size == 0.
+    bool empty() const;
+
+    /// \returns true if the size == capacity.
+    bool full() const;
+
+    /// \brief Remove all events, keeping the storage.
+    void clear();
+
+    /// \returns the number of pointers with events in the ring.
+    std::size_t numPointers() const;
+
+    /// \brief Determine if the ring has events for the given pointer id.
+    /// \param pointerId The pointer id to query.
+    /// \returns true if the ring has events for the pointer id.
+    bool hasPointerId(std::size_t pointerId) const;
+
+    /// \brief Add a pointer event, overwriting the oldest event if full.
+    /// \param pointerEvent The pointer event to add.
+    void add(const PointerEventArgs& pointerEvent);
+
+    /// \returns the total number of events overwritten.
+    uint64_t numOverwrittenEvents() const;
+
+    /// \brief Get an event by age.
+    /// \param index The index, where 0 is the oldest event.
+    /// \returns the event.
+    const PointerEventArgs& operator [] (std::size_t index) const;
+
+    /// \returns a view of all events, oldest first.
+    EventRange eventRange() const;
+
+    /// \brief Get a view of the events for a given pointer id.
+    /// \param pointerId The pointer id to query.
+    /// \returns a view of the events, oldest first, or an empty view if none.
+    EventRange eventRangeForPointerId(std::size_t pointerId) const;
+
+    /// \returns all events, oldest first.
+    std::vector<PointerEventArgs> events() const;
+
+    /// \brief Get the events for a given pointer id.
+    /// \param pointerId The pointer id to query.
+    /// \returns the events, oldest first, or an empty set if none.
+    std::vector<PointerEventArgs> eventsForPointerId(std::size_t pointerId) const;
+
+    /// \brief Get a pointer to the first event for a given pointer id.
+    /// \param pointerId The pointer id to query.
+    /// \returns a const pointer to the first event or nullptr if none.
+    const PointerEventArgs* firstEventForPointerId(std::size_t pointerId) const;
+
+    /// \brief Get a pointer to the last event for a given pointer id.
+    /// \param pointerId The pointer id to query.
+    /// \returns a const pointer to the last event or nullptr if none.
+    const PointerEventArgs* lastEventForPointerId(std::size_t pointerId) const;
+
+private:
+    /// \brief An invalid slot index.
+    static constexpr std::size_t NPOS = std::numeric_limits<std::size_t>::max();
+
+    /// \brief A stored event and its pointer list links.
+    struct Slot
+    {
+        /// \brief The stored event.
+        PointerEventArgs event;
+
+        /// \brief The next slot in the list of the pointer's events.
+        std::size_t pointerNext = NPOS;
+
+    };
+
+    /// \brief The list of a single pointer's events.
+    struct PointerList
+    {
+        /// \brief The first slot.
+        std::size_t first = NPOS;
+
+        /// \brief The last slot.
+        std::size_t last = NPOS;
+
+        /// \brief The number of slots.
+        std::size_t size = 0;
+
+    };
+
+    /// \brief An entry in the pointer table.
+    struct PointerEntry
+    {
+        /// \brief The pointer id.
+        std::size_t pointerId = 0;
+
+        /// \brief The pointer's events, or an empty list if the entry is unused.
+        PointerList list;
+
+    };
+
+    /// \brief Get the slot index following the given slot index.
+    /// \param index The slot index.
+    /// \param pointerOnly True if following the pointer's list.
+    /// \returns the next slot index or NPOS if none.
+    std::size_t _next(std::size_t index, bool pointerOnly) const;
+
+    /// \brief Get the preferred pointer table index for a pointer id.
+    /// \param pointerId The pointer id.
+    /// \returns the pointer table index.
+    std::size_t _home(std::size_t pointerId) const;
+
+    /// \brief Find the pointer table entry for a pointer id.
+    /// \param pointerId The pointer id.
+    /// \returns the pointer table index or NPOS if none.
+    std::size_t _findPointer(std::size_t pointerId) const;
+
+    /// \brief Find or add the pointer table entry for a pointer id.
+    /// \param pointerId The pointer id.
+    /// \returns the pointer's list.
+    PointerList& _addPointer(std::size_t pointerId);
+
+    /// \brief Remove a pointer table entry.
+    /// \param index The pointer table index.
+    void _erasePointer(std::size_t index);
+
+    /// \brief The event storage.
+    std::vector<Slot> _slots;
+
+    /// \brief The slot index of the oldest event.
+    std::size_t _first = 0;
+
+    /// \brief The number of events.
+    std::size_t _size = 0;
+
+    /// \brief The total number of events overwritten.
+    uint64_t _numOverwrittenEvents = 0;
+
+    /// \brief The number of samples stored per event without allocating.
+    std::size_t _samplesPerEvent = 0;
+
+    /// \brief The lists of events by pointer id.
+    ///
+    /// An open addressing table with two entries per slot, so it never fills.
+    std::vector<PointerEntry> _pointers;
 
-    /// \brief A mapping between the pointer event keys and the pointer events.
-    std::map<std::size_t, std::vector<PointerEventArgs*>> _eventsForPointerId;
+    /// \brief The number of pointers with events in the ring.
+    std::size_t _numPointers = 0;
 
 };
 
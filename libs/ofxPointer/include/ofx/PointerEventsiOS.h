@@ -35,9 +35,6 @@
     ofxiOSGLKView* _viewGLK;
     ofxiOSEAGLView* _viewEAGL;
 
-    /// \brief The start time of the program to calculate set timestamps based on elapsed time.
-    NSTimeInterval _startTimeSeconds;
-
     /// \brief Keep track of active pointers based on UITouchType.
     std::map<UITouchType, std::set<int64_t>> _activePointerIndices;
 
@@ -0,0 +1,110 @@
+//
+// Copyright (c) 2009 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#pragma once
+
+
+#include <istream>
+#include <ostream>
+#include "ofx/PointerEvents.h"
+
+
+namespace ofx {
+
+
+/// \brief Write PointerEventArgs as JSON Lines.
+///
+/// Each event is written as one JSON object per line, with the same keys and
+/// values as to_json(), without building a JSON document. The output can be
+/// read with from_json() or PointerEventJsonReader.
+class PointerEventJsonWriter
+{
+public:
+    /// \brief The number of bytes collected before they are written.
+    static constexpr std::size_t BUFFER_SIZE = 65536;
+
+    /// \brief Create a PointerEventJsonWriter.
+    /// \param stream The stream to write to.
+    PointerEventJsonWriter(std::ostream& stream);
+
+    /// \brief Destroy the PointerEventJsonWriter, writing any buffered events.
+    ~PointerEventJsonWriter();
+
+    /// \brief Write an event.
+    /// \param e The event to write.
+    /// \returns true if the stream is still good.
+    bool write(const PointerEventArgs& e);
+
+    /// \brief Write any buffered events to the stream.
+    /// \returns true if the stream is still good.
+    bool flush();
+
+    /// \returns the number of events written.
+    std::size_t numEvents() const;
+
+    /// \brief Append an event to a buffer as a line of JSON.
+    /// \param e The event to append.
+    /// \param buffer The buffer to append to.
+    static void append(const PointerEventArgs& e, std::string& buffer);
+
+private:
+    /// \brief The stream to write to.
+    std::ostream& _stream;
+
+    /// \brief The events waiting to be written.
+    std::string _buffer;
+
+    /// \brief The number of events written.
+    std::size_t _numEvents = 0;
+
+};
+
+
+/// \brief Read PointerEventArgs from JSON Lines.
+///
+/// Events are parsed directly from the text as each key is read, without
+/// building a JSON document. Unknown keys are skipped, and missing keys take
+/// the same defaults as from_json().
+class PointerEventJsonReader
+{
+public:
+    /// \brief Create a PointerEventJsonReader.
+    /// \param stream The stream to read from.
+    PointerEventJsonReader(std::istream& stream);
+
+    /// \brief Destroy the PointerEventJsonReader.
+    ~PointerEventJsonReader();
+
+    /// \brief Read the next event, skipping blank lines.
+    /// \param e The event that was read.
+    /// \returns true if an event was read, or false at the end of the stream or on error.
+    bool read(PointerEventArgs& e);
+
+    /// \returns the number of the last line read, starting at 1.
+    std::size_t lineNumber() const;
+
+    /// \brief Parse an event from a JSON object.
+    /// \param data The JSON text.
+    /// \param size The number of bytes of text.
+    /// \param e The parsed event.
+    /// \returns true if the text held a single valid event.
+    static bool parse(const char* data, std::size_t size, PointerEventArgs& e);
+
+private:
+    /// \brief The stream to read from.
+    std::istream& _stream;
+
+    /// \brief The line being parsed.
+    std::string _line;
+
+    /// \brief The number of the last line read.
+    std::size_t _lineNumber = 0;
+
+};
+
+
+} // namespace ofx
@@ -0,0 +1,257 @@
+//
+// Copyright (c) 2009 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#pragma once
+
+
+#include <array>
+#include <map>
+#include "ofx/PointerEvents.h"
+
+
+namespace ofx {
+
+
+/// \brief A base class for generating predicted pointer samples.
+///
+/// Predictors are updated with the measured samples of each pointer and
+/// extrapolate the pointer's position into the future. A PointerEvents
+/// instance with a predictor attaches predicted samples to each pointermove
+/// that does not already have platform-supplied predictions.
+class PointerPredictor
+{
+public:
+    /// \brief Create a PointerPredictor.
+    /// \param numPredictions The number of predicted samples per event.
+    /// \param horizonMicros The time of the last predicted sample after the event.
+    PointerPredictor(std::size_t numPredictions = 2,
+                     uint64_t horizonMicros = 16667);
+
+    /// \brief Destroy the PointerPredictor.
+    virtual ~PointerPredictor();
+
+    /// \brief Update the predictor with the measured samples of an event.
+    ///
+    /// Pointer down events restart the pointer's state and pointer up and
+    /// cancel events remove it.
+    ///
+    /// \param e The event to add.
+    void add(const PointerEventArgs& e);
+
+    /// \brief Predict the samples following the given event.
+    ///
+    /// Predicted samples are evenly spaced in time up to horizonMicros() after
+    /// the event and share the event's other properties.
+    ///
+    /// \param e The event to predict from.
+    /// \param predicted The buffer to add the predicted samples to.
+    /// \returns the number of predicted samples added.
+    std::size_t predict(const PointerEventArgs& e,
+                        PointerSampleBuffer& predicted) const;
+
+    /// \brief Predict the position of a pointer at the given time.
+    /// \param pointerId The pointer id.
+    /// \param timestampMicros The time to predict.
+    /// \param position The predicted position.
+    /// \returns true if there was enough data to make a prediction.
+    virtual bool predictPosition(std::size_t pointerId,
+                                 uint64_t timestampMicros,
+                                 glm::vec2& position) const = 0;
+
+    /// \brief Remove the state for the given pointer.
+    /// \param pointerId The pointer id.
+    virtual void reset(std::size_t pointerId) = 0;
+
+    /// \brief Remove the state for all pointers.
+    virtual void clear() = 0;
+
+    /// \brief Set the number of predicted samples per event.
+    /// \param numPredictions The number of predicted samples.
+    void setNumPredictions(std::size_t numPredictions);
+
+    /// \returns the number of predicted samples per event.
+    std::size_t getNumPredictions() const;
+
+    /// \brief Set the time of the last predicted sample after an event.
+    /// \param horizonMicros The prediction horizon in microseconds.
+    void setHorizonMicros(uint64_t horizonMicros);
+
+    /// \returns the time of the last predicted sample after an event.
+    uint64_t getHorizonMicros() const;
+
+protected:
+    /// \brief Add a measured sample for the given pointer.
+    /// \param pointerId The pointer id.
+    /// \param sample The measured sample.
+    virtual void _add(std::size_t pointerId, const PointerSample& sample) = 0;
+
+private:
+    /// \brief The number of predicted samples per event.
+    std::size_t _numPredictions = 2;
+
+    /// \brief The time of the last predicted sample after an event.
+    uint64_t _horizonMicros = 16667;
+
+};
+
+
+/// \brief A predictor that extrapolates the last measured velocity.
+class LinearPointerPredictor: public PointerPredictor
+{
+public:
+    using PointerPredictor::PointerPredictor;
+
+    /// \brief Destroy the LinearPointerPredictor.
+    virtual ~LinearPointerPredictor();
+
+    bool predictPosition(std::size_t pointerId,
+                         uint64_t timestampMicros,
+                         glm::vec2& position) const override;
+
+    void reset(std::size_t pointerId) override;
+
+    void clear() override;
+
+protected:
+    void _add(std::size_t pointerId, const PointerSample& sample) override;
+
+private:
+    /// \brief The last two samples by pointer id, oldest first.
+    std::map<std::size_t, std::vector<PointerSample>> _samples;
+
+};
+
+
+/// \brief A predictor that extrapolates a quadratic through the last three
+/// measured samples.
+///
+/// Falls back to linear extrapolation when only two samples are available.
+class QuadraticPointerPredictor: public PointerPredictor
+{
+public:
+    using PointerPredictor::PointerPredictor;
+
+    /// \brief Destroy the QuadraticPointerPredictor.
+    virtual ~QuadraticPointerPredictor();
+
+    bool predictPosition(std::size_t pointerId,
+                         uint64_t timestampMicros,
+                         glm::vec2& position) const override;
+
+    void reset(std::size_t pointerId) override;
+
+    void clear() override;
+
+protected:
+    void _add(std::size_t pointerId, const PointerSample& sample) override;
+
+private:
+    /// \brief The last three samples by pointer id, oldest first.
+    std::map<std::size_t, std::vector<PointerSample>> _samples;
+
+};
+
+
+/// \brief A predictor using a constant velocity Kalman filter.
+///
+/// Each axis is filtered independently. The filter smooths measurement noise
+/// at the cost of some lag when the pointer changes direction.
+class KalmanPointerPredictor: public PointerPredictor
+{
+public:
+    /// \brief Create a KalmanPointerPredictor.
+    /// \param numPredictions The number of predicted samples per event.
+    /// \param horizonMicros The time of the last predicted sample after the event.
+    /// \param processNoise The acceleration variance in pixels^2 / second^4.
+    /// \param measurementNoise The position variance in pixels^2.
+    KalmanPointerPredictor(std::size_t numPredictions = 2,
+                           uint64_t horizonMicros = 16667,
+                           double processNoise = 100000,
+                           double measurementNoise = 1);
+
+    /// \brief Destroy the KalmanPointerPredictor.
+    virtual ~KalmanPointerPredictor();
+
+    bool predictPosition(std::size_t pointerId,
+                         uint64_t timestampMicros,
+                         glm::vec2& position) const override;
+
+    void reset(std::size_t pointerId) override;
+
+    void clear() override;
+
+protected:
+    void _add(std::size_t pointerId, const PointerSample& sample) override;
+
+private:
+    /// \brief The filter state of a single pointer.
+    struct State
+    {
+        /// \brief The timestamp of the last measurement.
+        uint64_t timestampMicros = 0;
+
+        /// \brief The number of measurements.
+        std::size_t count = 0;
+
+        /// \brief The estimated position per axis.
+        std::array<double, 2> position = {{ 0, 0 }};
+
+        /// \brief The estimated velocity in pixels / second per axis.
+        std::array<double, 2> velocity = {{ 0, 0 }};
+
+        /// \brief The symmetric covariance [p00, p01, p11], shared by both axes.
+        std::array<double, 3> covariance = {{ 0, 0, 0 }};
+
+    };
+
+    /// \brief The acceleration variance in pixels^2 / second^4.
+    double _processNoise = 100000;
+
+    /// \brief The position variance in pixels^2.
+    double _measurementNoise = 1;
+
+    /// \brief The filter states by pointer id.
+    std::map<std::size_t, State> _states;
+
+};
+
+
+/// \brief Prediction error statistics in pixels.
+struct PointerPredictionError
+{
+    /// \brief The number of predictions measured.
+    std::size_t count = 0;
+
+    /// \brief The mean error.
+    double mean = 0;
+
+    /// \brief The root mean square error.
+    double rms = 0;
+
+    /// \brief The maximum error.
+    double max = 0;
+
+};
+
+
+/// \brief Measure the prediction error of a predictor on a recorded stroke.
+///
+/// The stroke's measured samples are added to the predictor in order. After
+/// each sample, the position horizonMicros in the future is predicted and
+/// compared with the recorded position at that time, interpolated between
+/// samples. The predictor's state for the stroke's pointer is reset first.
+///
+/// \param predictor The predictor to measure.
+/// \param stroke The recorded stroke.
+/// \param horizonMicros The prediction horizon in microseconds.
+/// \returns the prediction error.
+PointerPredictionError measurePredictionError(PointerPredictor& predictor,
+                                              const PointerStroke& stroke,
+                                              uint64_t horizonMicros);
+
+
+} // namespace ofx
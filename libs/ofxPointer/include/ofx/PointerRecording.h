@@ -0,0 +1,1041 @@
+//
+// Copyright (c) 2009 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#pragma once
+
+
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <thread>
+#include "ofThreadChannel.h"
+#include "ofx/PointerEvents.h"
+
+
+namespace ofx {
+
+
+/// \brief The settings of a binary pointer event recording.
+///
+/// A recording begins with a fixed-width header followed by length-prefixed
+/// event records. Timestamps, sequence indices and quantized positions are
+/// delta coded as variable length integers. Keyframe records reset the delta
+/// state, so decoding can begin at any keyframe.
+struct PointerRecordingFormat
+{
+    /// \brief The magic bytes at the start of a recording.
+    static const std::array<uint8_t, 4> MAGIC;
+
+    /// \brief The current format version.
+    static constexpr uint16_t VERSION = 1;
+
+    /// \brief The size of the header in bytes.
+    static constexpr std::size_t HEADER_SIZE = 16;
+
+    /// \brief The largest record payload in bytes.
+    ///
+    /// Records with a larger length prefix are treated as corrupt.
+    static constexpr std::size_t MAX_RECORD_SIZE = 1 << 20;
+
+    /// \brief The number of position units per pixel.
+    ///
+    /// Positions are rounded to the nearest unit and delta coded. When 0,
+    /// positions are stored exactly as 32-bit floats.
+    uint32_t positionScale = 0;
+
+    /// \brief The number of events between keyframes.
+    ///
+    /// When 0, only the first event is a keyframe.
+    uint32_t keyframeInterval = 256;
+
+};
+
+
+/// \brief Encode PointerEventArgs as binary records.
+///
+/// Events are encoded in the order they are given. All properties written
+/// by to_json() are encoded, except the event source.
+class PointerEventEncoder
+{
+public:
+    /// \brief Create a PointerEventEncoder.
+    /// \param format The recording format.
+    PointerEventEncoder(const PointerRecordingFormat& format = PointerRecordingFormat());
+
+    /// \brief Destroy the PointerEventEncoder.
+    ~PointerEventEncoder();
+
+    /// \brief Append the recording header to a buffer.
+    /// \param buffer The buffer to append to.
+    void encodeHeader(std::vector<uint8_t>& buffer) const;
+
+    /// \brief Append an event record to a buffer.
+    /// \param e The event to encode.
+    /// \param buffer The buffer to append to.
+    /// \returns true if the record is a keyframe.
+    bool encode(const PointerEventArgs& e, std::vector<uint8_t>& buffer);
+
+    /// \brief Make the next record a keyframe.
+    void reset();
+
+    /// \returns the recording format.
+    const PointerRecordingFormat& format() const;
+
+private:
+    /// \brief The delta state of a pointer.
+    struct PointerState
+    {
+        /// \brief The pointer id.
+        std::size_t pointerId = 0;
+
+        /// \brief The last quantized position.
+        std::array<int64_t, 2> position = {{ 0, 0 }};
+
+    };
+
+    /// \brief The recording format.
+    PointerRecordingFormat _format;
+
+    /// \brief The number of records since the last keyframe.
+    std::size_t _numRecordsSinceKeyframe = 0;
+
+    /// \brief True if the next record must be a keyframe.
+    bool _needsKeyframe = true;
+
+    /// \brief The timestamp of the last record.
+    uint64_t _timestampMicros = 0;
+
+    /// \brief The sequence index of the last record.
+    uint64_t _sequenceIndex = 0;
+
+    /// \brief The pointers seen since the last keyframe in order of appearance.
+    std::vector<PointerState> _pointers;
+
+    /// \brief The index in _pointers of each pointer id.
+    std::unordered_map<std::size_t, std::size_t> _pointerIndices;
+
+    /// \brief The record being encoded.
+    std::vector<uint8_t> _record;
+
+};
+
+
+/// \brief Decode PointerEventArgs from binary records.
+class PointerEventDecoder
+{
+public:
+    /// \brief Create a PointerEventDecoder.
+    PointerEventDecoder();
+
+    /// \brief Destroy the PointerEventDecoder.
+    ~PointerEventDecoder();
+
+    /// \brief Decode the recording header.
+    /// \param data The header data.
+    /// \param size The number of bytes available.
+    /// \returns the number of bytes consumed or 0 if the header is invalid.
+    std::size_t decodeHeader(const uint8_t* data, std::size_t size);
+
+    /// \brief Decode an event record.
+    ///
+    /// Records that are not keyframes can only be decoded after the records
+    /// preceding them, back to the last keyframe.
+    ///
+    /// \param data The record data.
+    /// \param size The number of bytes available.
+    /// \param e The decoded event.
+    /// \returns the number of bytes consumed or 0 if the record is incomplete or invalid.
+    std::size_t decode(const uint8_t* data, std::size_t size, PointerEventArgs& e);
+
+    /// \brief Require a keyframe before the next record.
+    void reset();
+
+    /// \returns the recording format of the decoded header.
+    const PointerRecordingFormat& format() const;
+
+    /// \brief Read the size of the record at the given data.
+    /// \param data The record data.
+    /// \param size The number of bytes available.
+    /// \param recordSize The size of the record including its length prefix.
+    /// \returns true if enough bytes were available to read the size and the
+    ///     size is no larger than PointerRecordingFormat::MAX_RECORD_SIZE.
+    static bool recordSize(const uint8_t* data, std::size_t size, std::size_t& recordSize);
+
+    /// \brief Determine if the record at the given data is a keyframe.
+    /// \param data The record data.
+    /// \param size The number of bytes available.
+    /// \returns true if the record is a keyframe.
+    static bool isKeyframe(const uint8_t* data, std::size_t size);
+
+private:
+    /// \brief Decode a record payload.
+    /// \param data The payload data.
+    /// \param end The end of the payload data.
+    /// \param e The decoded event.
+    /// \returns true if the payload was valid.
+    bool _decodePayload(const uint8_t* data, const uint8_t* end, PointerEventArgs& e);
+
+    /// \brief The delta state of a pointer.
+    struct PointerState
+    {
+        /// \brief The pointer id.
+        std::size_t pointerId = 0;
+
+        /// \brief The last quantized position.
+        std::array<int64_t, 2> position = {{ 0, 0 }};
+
+    };
+
+    /// \brief The recording format.
+    PointerRecordingFormat _format;
+
+    /// \brief True if the next record must be a keyframe.
+    bool _needsKeyframe = true;
+
+    /// \brief The timestamp of the last record.
+    uint64_t _timestampMicros = 0;
+
+    /// \brief The sequence index of the last record.
+    uint64_t _sequenceIndex = 0;
+
+    /// \brief The pointers seen since the last keyframe in order of appearance.
+    std::vector<PointerState> _pointers;
+
+};
+
+
+/// \brief Write a binary pointer event recording to a stream.
+class PointerEventWriter
+{
+public:
+    /// \brief Create a PointerEventWriter and write the recording header.
+    /// \param stream The stream to write to.
+    /// \param format The recording format.
+    PointerEventWriter(std::ostream& stream,
+                       const PointerRecordingFormat& format = PointerRecordingFormat());
+
+    /// \brief Destroy the PointerEventWriter.
+    ~PointerEventWriter();
+
+    /// \brief Write an event.
+    /// \param e The event to write.
+    /// \returns true if the stream is still good.
+    bool write(const PointerEventArgs& e);
+
+    /// \returns the number of events written.
+    std::size_t numEvents() const;
+
+private:
+    /// \brief The stream to write to.
+    std::ostream& _stream;
+
+    /// \brief The encoder.
+    PointerEventEncoder _encoder;
+
+    /// \brief The encoded data waiting to be written.
+    std::vector<uint8_t> _buffer;
+
+    /// \brief The number of events written.
+    std::size_t _numEvents = 0;
+
+};
+
+
+/// \brief Read a binary pointer event recording from a stream.
+class PointerEventReader
+{
+public:
+    /// \brief Create a PointerEventReader and read the recording header.
+    /// \param stream The stream to read from.
+    PointerEventReader(std::istream& stream);
+
+    /// \brief Destroy the PointerEventReader.
+    ~PointerEventReader();
+
+    /// \returns true if a valid header was read.
+    bool isValid() const;
+
+    /// \brief Read the next event.
+    /// \param e The event that was read.
+    /// \returns true if an event was read, or false at the end of the stream or on error.
+    bool read(PointerEventArgs& e);
+
+    /// \returns the recording format.
+    const PointerRecordingFormat& format() const;
+
+private:
+    /// \brief The stream to read from.
+    std::istream& _stream;
+
+    /// \brief The decoder.
+    PointerEventDecoder _decoder;
+
+    /// \brief True if a valid header was read.
+    bool _isValid = false;
+
+    /// \brief The record being decoded.
+    std::vector<uint8_t> _record;
+
+};
+
+
+/// \brief Random access to a binary pointer event recording file.
+///
+/// The file is memory-mapped and events are decoded on demand directly from
+/// the mapped data, so recordings larger than memory can be read. A sparse
+/// index of the keyframes records the offset, first event and latest
+/// timestamp of each block of events and the pointers that appear in each
+/// block. Seeking to a time or event is a binary search of the index followed
+/// by decoding at most one block of events.
+///
+/// The index is built by scanning the file once and saved next to it with
+/// INDEX_EXTENSION, so later opens only read the index. Random access is only
+/// as fine as the keyframe interval of the recording.
+///
+/// Like PointerEventCollection, timestamps are expected to be in order. An
+/// event with an earlier timestamp than a previous event is indexed at the
+/// latest timestamp seen so far.
+///
+/// Decoding keeps a cursor, so reading events in order is O(1) per event. A
+/// PointerRecordingFile must not be read from more than one thread at a time.
+class PointerRecordingFile
+{
+public:
+    /// \brief The extension appended to the recording path for its index.
+    static const std::string INDEX_EXTENSION;
+
+    /// \brief An index entry for a keyframe.
+    struct Keyframe
+    {
+        /// \brief The offset of the keyframe record in the file.
+        uint64_t offset = 0;
+
+        /// \brief The index of the keyframe event.
+        uint64_t eventIndex = 0;
+
+        /// \brief The latest timestamp up to the end of the keyframe's block.
+        uint64_t maxTimestampMicros = 0;
+
+    };
+
+    /// \brief Create a closed PointerRecordingFile.
+    PointerRecordingFile();
+
+    PointerRecordingFile(const PointerRecordingFile&) = delete;
+    PointerRecordingFile& operator = (const PointerRecordingFile&) = delete;
+
+    /// \brief Destroy the PointerRecordingFile.
+    ~PointerRecordingFile();
+
+    /// \brief Open a recording.
+    ///
+    /// A saved index is used if it matches the recording. Otherwise the index
+    /// is built and, if \p saveIndex is true, saved. An incomplete record at
+    /// the end of the file, such as from an interrupted recording, is ignored.
+    ///
+    /// \param path The path of the recording, relative to the data folder.
+    /// \param saveIndex True if a built index should be saved.
+    /// \returns true if the recording was opened.
+    bool open(const std::string& path, bool saveIndex = true);
+
+    /// \brief Close the recording.
+    void close();
+
+    /// \returns true if a recording is open.
+    bool isOpen() const;
+
+    /// \returns the recording format.
+    const PointerRecordingFormat& format() const;
+
+    /// \returns the number of events in the recording.
+    std::size_t numEvents() const;
+
+    /// \returns the latest timestamp in the recording.
+    uint64_t maxTimestampMicros() const;
+
+    /// \brief Decode an event.
+    /// \param index The index of the event.
+    /// \param e The decoded event.
+    /// \returns true if the event was decoded.
+    bool event(std::size_t index, PointerEventArgs& e) const;
+
+    /// \brief Find the first event at or after a time.
+    ///
+    /// This is O(log n) plus decoding at most one block of events.
+    ///
+    /// \param timestampMicros The timestamp to find.
+    /// \returns the index of the event or numEvents() if there is none.
+    std::size_t seek(uint64_t timestampMicros) const;
+
+    /// \returns the ids of all pointers in the recording.
+    std::vector<std::size_t> pointerIds() const;
+
+    /// \brief Find the next event of a pointer.
+    ///
+    /// Blocks without events for the pointer are skipped without decoding.
+    ///
+    /// \param pointerId The pointer id to find.
+    /// \param index The index of the first event to consider.
+    /// \returns the index of the event or numEvents() if there is none.
+    std::size_t nextEventForPointerId(std::size_t pointerId, std::size_t index) const;
+
+    /// \brief Add the events in a time range to a collection.
+    /// \param minTimestampMicros The minimum timestamp, inclusive.
+    /// \param maxTimestampMicros The maximum timestamp, inclusive.
+    /// \param collection The collection to add the events to.
+    /// \returns the number of events added.
+    std::size_t read(uint64_t minTimestampMicros,
+                     uint64_t maxTimestampMicros,
+                     PointerEventCollection& collection) const;
+
+    /// \returns the keyframe index.
+    const std::vector<Keyframe>& keyframes() const;
+
+private:
+    /// \brief Map the file into memory.
+    /// \param path The absolute path of the file.
+    /// \returns true if the file was mapped.
+    bool _map(const std::string& path);
+
+    /// \brief Unmap the file.
+    void _unmap();
+
+    /// \brief Build the index by decoding every event.
+    /// \returns true if the recording was valid.
+    bool _buildIndex();
+
+    /// \brief Load a saved index.
+    /// \param path The path of the index.
+    /// \returns true if a valid index for the recording was loaded.
+    bool _loadIndex(const std::string& path);
+
+    /// \brief Save the index.
+    /// \param path The path of the index.
+    /// \returns true if the index was saved.
+    bool _saveIndex(const std::string& path) const;
+
+    /// \brief Find the keyframe whose block contains an event.
+    /// \param index The index of the event.
+    /// \returns the index of the keyframe.
+    std::size_t _keyframeForEvent(std::size_t index) const;
+
+    /// \brief Decode the event at the cursor and advance the cursor.
+    /// \param e The decoded event.
+    /// \returns true if the event was decoded.
+    bool _decodeNext(PointerEventArgs& e) const;
+
+    /// \brief Move the cursor to the start of a keyframe's block.
+    /// \param keyframe The index of the keyframe.
+    void _moveCursor(std::size_t keyframe) const;
+
+    /// \brief The mapped data.
+    const uint8_t* _data = nullptr;
+
+    /// \brief The size of the mapped data in bytes.
+    std::size_t _size = 0;
+
+    /// \brief The platform file mapping handle, if needed.
+    void* _mapping = nullptr;
+
+    /// \brief The size of the recording header in bytes.
+    std::size_t _headerSize = 0;
+
+    /// \brief The number of complete events in the recording.
+    std::size_t _numEvents = 0;
+
+    /// \brief The keyframe index.
+    std::vector<Keyframe> _keyframes;
+
+    /// \brief The keyframes whose blocks contain events of each pointer, in order.
+    std::unordered_map<std::size_t, std::vector<std::size_t>> _pointerKeyframes;
+
+    /// \brief The decoder positioned at the cursor.
+    mutable PointerEventDecoder _decoder;
+
+    /// \brief The index of the event at the cursor.
+    mutable std::size_t _cursorIndex = 0;
+
+    /// \brief The offset of the event at the cursor.
+    mutable std::size_t _cursorOffset = 0;
+
+};
+
+
+/// \brief Record the events of a PointerEvents instance to a file.
+///
+/// Events are encoded as they are dispatched and written to disk on a
+/// background thread in blocks of BUFFER_SIZE bytes.
+class PointerEventRecorder
+{
+public:
+    /// \brief The number of encoded bytes collected before they are written.
+    static constexpr std::size_t BUFFER_SIZE = 65536;
+
+    /// \brief Create a PointerEventRecorder.
+    PointerEventRecorder();
+
+    /// \brief Destroy the PointerEventRecorder, stopping any recording.
+    ~PointerEventRecorder();
+
+    /// \brief Start recording.
+    ///
+    /// The recorder listens to the pointerEvent event before the app, so
+    /// events are recorded even if they are consumed by the app.
+    ///
+    /// \param events The PointerEvents to record.
+    /// \param path The path of the recording, relative to the data folder.
+    /// \param format The recording format.
+    /// \returns true if the file was opened.
+    bool start(PointerEvents& events,
+               const std::string& path,
+               const PointerRecordingFormat& format = PointerRecordingFormat());
+
+    /// \brief Stop recording and finish writing the file.
+    void stop();
+
+    /// \returns true if recording.
+    bool isRecording() const;
+
+    /// \returns the number of events recorded since recording started.
+    std::size_t numEvents() const;
+
+    /// \brief Record a pointer event.
+    /// \param e The event to record.
+    /// \returns false, so the event is passed on.
+    bool onPointerEvent(PointerEventArgs& e);
+
+private:
+    /// \brief Pass the encoded data to the writing thread.
+    void _send();
+
+    /// \brief Write the encoded data received from the channel until stopped.
+    void _write();
+
+    /// \brief The pointerEvent listener.
+    ofEventListener _pointerEventListener;
+
+    /// \brief The encoder.
+    PointerEventEncoder _encoder;
+
+    /// \brief The encoded data waiting to be sent.
+    std::vector<uint8_t> _buffer;
+
+    /// \brief The channel of encoded data to write. An empty block stops the thread.
+    ofThreadChannel<std::vector<uint8_t>> _channel;
+
+    /// \brief The writing thread.
+    std::thread _thread;
+
+    /// \brief The file being written, used only by the writing thread.
+    std::ofstream _stream;
+
+    /// \brief The number of events recorded.
+    std::size_t _numEvents = 0;
+
+    /// \brief True if recording.
+    bool _isRecording = false;
+
+};
+
+
+/// \brief Play a recording back through a PointerEvents instance.
+///
+/// The recording is read with a PointerRecordingFile, so it is not loaded
+/// into memory and playback can start from any time.
+///
+/// Events are passed to PointerEvents::onPointerEvent() from update(). With
+/// a speed of 1, events are played when the time since play() matches the
+/// time since the first event. Other speeds scale the elapsed time, and
+/// AS_FAST_AS_POSSIBLE plays every remaining event in the next update(), for
+/// measuring the throughput of the dispatch path.
+///
+/// Events keep their recorded timestamps. Consumers that compare timestamps
+/// with a clock can use a ManualPointerClock that the player sets to the
+/// timestamp of each event as it is played.
+class PointerEventPlayer
+{
+public:
+    /// \brief The speed that plays all events without waiting.
+    static const double AS_FAST_AS_POSSIBLE;
+
+    /// \brief Create a PointerEventPlayer.
+    PointerEventPlayer();
+
+    /// \brief Destroy the PointerEventPlayer.
+    ~PointerEventPlayer();
+
+    /// \brief Load a recording.
+    /// \param path The path of the recording, relative to the data folder.
+    /// \returns true if a valid recording was opened.
+    bool load(const std::string& path);
+
+    /// \brief Start playing the loaded recording.
+    ///
+    /// Playback starts from the current position, or from the beginning if
+    /// the previous playback reached the end.
+    ///
+    /// \param events The PointerEvents to play the events through.
+    /// \returns true if playback started.
+    bool play(PointerEvents& events);
+
+    /// \brief Stop playing, keeping the current position.
+    void stop();
+
+    /// \returns true if playing.
+    bool isPlaying() const;
+
+    /// \brief Move the playback position to the first event at or after a time.
+    /// \param timestampMicros The recorded timestamp to move to.
+    void seek(uint64_t timestampMicros);
+
+    /// \returns the index of the next event to play.
+    std::size_t position() const;
+
+    /// \returns the loaded recording.
+    const PointerRecordingFile& file() const;
+
+    /// \brief Play the events that are due.
+    /// \returns the number of events played.
+    std::size_t update();
+
+    /// \brief Set the playback speed.
+    ///
+    /// Speeds that are not greater than 0, including NaN, are rejected and the
+    /// speed is unchanged. Use stop() to pause playback.
+    ///
+    /// \param speed The playback speed greater than 0, where 1 is real time,
+    ///     or AS_FAST_AS_POSSIBLE.
+    void setSpeed(double speed);
+
+    /// \returns the playback speed.
+    double getSpeed() const;
+
+    /// \brief Set a clock to advance to the timestamp of each played event.
+    /// \param clock The clock or nullptr for none.
+    void setClock(std::shared_ptr<ManualPointerClock> clock);
+
+    /// \returns the clock advanced by playback or nullptr.
+    std::shared_ptr<ManualPointerClock> getClock() const;
+
+    /// \returns the number of events played since playback started.
+    std::size_t numEvents() const;
+
+private:
+    /// \brief Start timing playback from the event at the current position.
+    /// \returns true if there is an event to play.
+    bool _restart();
+
+    /// \brief The loaded recording.
+    PointerRecordingFile _file;
+
+    /// \brief The index of the next event to play.
+    std::size_t _position = 0;
+
+    /// \brief The PointerEvents to play the events through.
+    PointerEvents* _events = nullptr;
+
+    /// \brief The next event to play.
+    PointerEventArgs _next;
+
+    /// \brief True if _next holds the event at _position.
+    bool _hasNext = false;
+
+    /// \brief The wall clock time playback started in microseconds.
+    uint64_t _startMicros = 0;
+
+    /// \brief The timestamp of the first event in microseconds.
+    uint64_t _firstTimestampMicros = 0;
+
+    /// \brief The playback speed.
+    double _speed = 1;
+
+    /// \brief The clock advanced by playback.
+    std::shared_ptr<ManualPointerClock> _clock;
+
+    /// \brief The number of events played.
+    std::size_t _numEvents = 0;
+
+    /// \brief True if playing.
+    bool _isPlaying = false;
+
+};
+
+
+/// \brief The columns of a pointer event archive.
+///
+/// There is one column for each value written by to_json(), with the Point
+/// and PointShape values flattened. Event and device type strings are stored
+/// as ids into the archive dictionary.
+enum class PointerArchiveColumn: uint8_t
+{
+    ROW_TYPE,
+    EVENT_TYPE,
+    TIMESTAMP_MICROS,
+    DETAIL,
+    POSITION_X,
+    POSITION_Y,
+    PRECISE_POSITION_X,
+    PRECISE_POSITION_Y,
+    SHAPE_TYPE,
+    WIDTH,
+    HEIGHT,
+    WIDTH_TOLERANCE,
+    HEIGHT_TOLERANCE,
+    ANGLE_DEG,
+    PRESSURE,
+    TANGENTIAL_PRESSURE,
+    TWIST_DEG,
+    TILT_X_DEG,
+    TILT_Y_DEG,
+    POINTER_ID,
+    DEVICE_ID,
+    POINTER_INDEX,
+    SEQUENCE_INDEX,
+    DEVICE_TYPE,
+    IS_COALESCED,
+    IS_PREDICTED,
+    IS_PRIMARY,
+    BUTTON,
+    BUTTONS,
+    MODIFIERS,
+    ESTIMATED_PROPERTIES,
+    ESTIMATED_PROPERTIES_EXPECTING_UPDATES
+};
+
+
+/// \brief The settings of a columnar pointer event archive.
+///
+/// An archive stores rows in chunks. Each chunk stores each column
+/// separately, with the minimum and maximum of each column kept in a footer,
+/// so a query only reads the columns it uses from the chunks that can match.
+///
+/// Like to_json(), coalesced and predicted samples are stored as complete
+/// rows. Each event row is followed by the rows of its samples, marked by the
+/// ROW_TYPE column.
+///
+/// Integer columns are delta coded, zigzag coded and written as variable
+/// length integers. Float columns are coded as the XOR of each value's bits
+/// with the previous value's bits, or quantized and delta coded.
+struct PointerArchiveFormat
+{
+    /// \brief The magic bytes at the start and end of an archive.
+    static const std::array<uint8_t, 4> MAGIC;
+
+    /// \brief The current format version.
+    static constexpr uint16_t VERSION = 1;
+
+    /// \brief The size of the header in bytes.
+    static constexpr std::size_t HEADER_SIZE = 16;
+
+    /// \brief The number of columns.
+    static constexpr std::size_t NUM_COLUMNS = std::size_t(PointerArchiveColumn::ESTIMATED_PROPERTIES_EXPECTING_UPDATES) + 1;
+
+    /// \brief The ROW_TYPE of an event.
+    static constexpr int64_t ROW_EVENT = 0;
+
+    /// \brief The ROW_TYPE of a coalesced sample of the preceding event.
+    static constexpr int64_t ROW_COALESCED = 1;
+
+    /// \brief The ROW_TYPE of a predicted sample of the preceding event.
+    static constexpr int64_t ROW_PREDICTED = 2;
+
+    /// \brief The number of position units per pixel.
+    ///
+    /// Positions are rounded to the nearest unit and delta coded. When 0,
+    /// positions are stored exactly like other float columns.
+    uint32_t positionScale = 0;
+
+    /// \brief The number of rows after which a chunk is finished.
+    ///
+    /// Chunks only end between events, so a chunk can hold a few more rows.
+    uint32_t chunkSize = 4096;
+
+    /// \returns the name of a column, e.g. "pressure".
+    static const std::string& columnName(PointerArchiveColumn column);
+
+    /// \returns true if the column holds float values.
+    static bool isFloatColumn(PointerArchiveColumn column);
+
+};
+
+
+/// \brief The range of a column in a chunk.
+///
+/// Integer columns use the integer range and float columns use the float
+/// range. NaN values are not included in the float range.
+struct PointerArchiveColumnStats
+{
+    /// \brief The minimum integer value.
+    int64_t minInteger = 0;
+
+    /// \brief The maximum integer value.
+    int64_t maxInteger = 0;
+
+    /// \brief The minimum float value.
+    float minFloat = 0;
+
+    /// \brief The maximum float value.
+    float maxFloat = 0;
+
+};
+
+
+/// \brief The location and range of a column in a chunk.
+struct PointerArchiveColumnInfo
+{
+    /// \brief The offset of the column data in the archive.
+    uint64_t offset = 0;
+
+    /// \brief The size of the column data in bytes.
+    uint64_t size = 0;
+
+    /// \brief The range of the column.
+    PointerArchiveColumnStats stats;
+
+};
+
+
+/// \brief Write PointerEventArgs to a columnar archive.
+///
+/// Rows are collected until a chunk is full and then written column by
+/// column. The footer is written by close().
+class PointerArchiveWriter
+{
+public:
+    /// \brief Create a PointerArchiveWriter and write the archive header.
+    /// \param stream The stream to write to.
+    /// \param format The archive format.
+    PointerArchiveWriter(std::ostream& stream,
+                         const PointerArchiveFormat& format = PointerArchiveFormat());
+
+    /// \brief Destroy the PointerArchiveWriter, closing the archive.
+    ~PointerArchiveWriter();
+
+    /// \brief Add an event and its samples.
+    /// \param e The event to add.
+    /// \returns true if the stream is still good.
+    bool add(const PointerEventArgs& e);
+
+    /// \brief Write the last chunk and the footer.
+    ///
+    /// No events can be added after the archive is closed.
+    ///
+    /// \returns true if the stream is still good.
+    bool close();
+
+    /// \returns the number of events added.
+    std::size_t numEvents() const;
+
+    /// \returns the number of rows added, including samples.
+    std::size_t numRows() const;
+
+private:
+    /// \brief Add a row for an event or one of its samples.
+    void _addRow(const PointerEventArgs& e, const PointerSample& sample, int64_t rowType);
+
+    /// \brief Add an integer value to the current chunk.
+    void _add(PointerArchiveColumn column, int64_t value);
+
+    /// \brief Add a float value to the current chunk.
+    void _add(PointerArchiveColumn column, float value);
+
+    /// \returns the dictionary id of a string, adding it if needed.
+    int64_t _dictionaryId(const std::string& value);
+
+    /// \brief Write the current chunk.
+    void _writeChunk();
+
+    /// \brief The stream to write to.
+    std::ostream& _stream;
+
+    /// \brief The archive format.
+    PointerArchiveFormat _format;
+
+    /// \brief The values of each column in the current chunk.
+    ///
+    /// Float columns hold the bits of each value.
+    std::array<std::vector<int64_t>, PointerArchiveFormat::NUM_COLUMNS> _columns;
+
+    /// \brief The number of bytes written.
+    uint64_t _offset = 0;
+
+    /// \brief The number of rows in each chunk written.
+    std::vector<std::size_t> _chunkRows;
+
+    /// \brief The columns of each chunk written.
+    std::vector<std::array<PointerArchiveColumnInfo, PointerArchiveFormat::NUM_COLUMNS>> _chunkColumns;
+
+    /// \brief The dictionary strings in order of id.
+    std::vector<std::string> _dictionary;
+
+    /// \brief The id of each dictionary string.
+    std::unordered_map<std::string, int64_t> _dictionaryIds;
+
+    /// \brief The column being encoded.
+    std::vector<uint8_t> _buffer;
+
+    /// \brief The number of events added.
+    std::size_t _numEvents = 0;
+
+    /// \brief The number of rows added.
+    std::size_t _numRows = 0;
+
+    /// \brief True if the archive was closed.
+    bool _isClosed = false;
+
+};
+
+
+/// \brief Read a columnar pointer event archive.
+///
+/// Opening an archive only reads its header and footer. Columns are read
+/// from the file when requested.
+///
+/// A pressure histogram for pens, for example, skips the chunks whose
+/// DEVICE_TYPE range does not include the id of PointerEventArgs::TYPE_PEN
+/// and reads only the DEVICE_TYPE and PRESSURE columns of the others.
+class PointerArchiveReader
+{
+public:
+    /// \brief Create a PointerArchiveReader.
+    PointerArchiveReader();
+
+    /// \brief Destroy the PointerArchiveReader.
+    ~PointerArchiveReader();
+
+    /// \brief Open an archive.
+    /// \param path The path of the archive, relative to the data folder.
+    /// \returns true if a valid archive was opened.
+    bool open(const std::string& path);
+
+    /// \brief Close the archive.
+    void close();
+
+    /// \returns true if an archive is open.
+    bool isOpen() const;
+
+    /// \returns the archive format.
+    const PointerArchiveFormat& format() const;
+
+    /// \returns the number of rows in the archive, including samples.
+    std::size_t numRows() const;
+
+    /// \returns the number of chunks in the archive.
+    std::size_t numChunks() const;
+
+    /// \param chunk The index of the chunk.
+    /// \returns the number of rows in the chunk or 0 if there is no such chunk.
+    std::size_t numRows(std::size_t chunk) const;
+
+    /// \returns the strings of the EVENT_TYPE and DEVICE_TYPE columns in order of id.
+    const std::vector<std::string>& dictionary() const;
+
+    /// \param value The string to find.
+    /// \returns the dictionary id of the string or -1 if it is not in the archive.
+    int64_t dictionaryId(const std::string& value) const;
+
+    /// \param chunk The index of the chunk.
+    /// \param column The column.
+    /// \returns the range of the column in the chunk, or an empty range if
+    ///     there is no such chunk or column.
+    const PointerArchiveColumnStats& stats(std::size_t chunk, PointerArchiveColumn column) const;
+
+    /// \brief Determine if an integer column of a chunk can hold values in a range.
+    /// \param chunk The index of the chunk.
+    /// \param column The integer column.
+    /// \param minValue The minimum value, inclusive.
+    /// \param maxValue The maximum value, inclusive.
+    /// \returns false if the chunk can be skipped or there is no such chunk.
+    bool mayContain(std::size_t chunk,
+                    PointerArchiveColumn column,
+                    int64_t minValue,
+                    int64_t maxValue) const;
+
+    /// \brief Determine if a float column of a chunk can hold values in a range.
+    /// \param chunk The index of the chunk.
+    /// \param column The float column.
+    /// \param minValue The minimum value, inclusive.
+    /// \param maxValue The maximum value, inclusive.
+    /// \returns false if the chunk can be skipped or there is no such chunk.
+    bool mayContain(std::size_t chunk,
+                    PointerArchiveColumn column,
+                    float minValue,
+                    float maxValue) const;
+
+    /// \brief Read an integer column of a chunk.
+    /// \param chunk The index of the chunk.
+    /// \param column The integer column.
+    /// \param values The values of each row of the chunk.
+    /// \returns true if the column was read.
+    bool readColumn(std::size_t chunk, PointerArchiveColumn column, std::vector<int64_t>& values);
+
+    /// \brief Read a float column of a chunk.
+    /// \param chunk The index of the chunk.
+    /// \param column The float column.
+    /// \param values The values of each row of the chunk.
+    /// \returns true if the column was read.
+    bool readColumn(std::size_t chunk, PointerArchiveColumn column, std::vector<float>& values);
+
+    /// \brief Read the events of a chunk.
+    /// \param chunk The index of the chunk.
+    /// \param events The events of the chunk.
+    /// \returns true if the events were read.
+    bool readEvents(std::size_t chunk, std::vector<PointerEventArgs>& events);
+
+    /// \returns the number of column bytes read since the archive was opened.
+    uint64_t numBytesRead() const;
+
+private:
+    /// \brief Read the footer.
+    /// \param size The size of the archive.
+    /// \returns true if the footer was valid.
+    bool _readFooter(uint64_t size);
+
+    /// \brief Read and decode a column of a chunk.
+    /// \param chunk The index of the chunk.
+    /// \param column The column.
+    /// \param values The decoded values. Float columns hold the bits of each value.
+    /// \returns true if the column was read.
+    bool _readColumn(std::size_t chunk, PointerArchiveColumn column, std::vector<int64_t>& values);
+
+    /// \brief Determine if the archive has a column of a chunk.
+    /// \param chunk The index of the chunk.
+    /// \param column The column.
+    /// \returns true if the chunk and column exist.
+    bool _hasColumn(std::size_t chunk, PointerArchiveColumn column) const;
+
+    /// \brief The archive.
+    std::ifstream _stream;
+
+    /// \brief The archive format.
+    PointerArchiveFormat _format;
+
+    /// \brief The number of rows.
+    std::size_t _numRows = 0;
+
+    /// \brief The number of rows in each chunk.
+    std::vector<std::size_t> _chunkRows;
+
+    /// \brief The columns of each chunk.
+    std::vector<std::array<PointerArchiveColumnInfo, PointerArchiveFormat::NUM_COLUMNS>> _chunkColumns;
+
+    /// \brief The dictionary strings in order of id.
+    std::vector<std::string> _dictionary;
+
+    /// \brief The column being decoded.
+    std::vector<uint8_t> _buffer;
+
+    /// \brief The number of column bytes read.
+    uint64_t _numBytesRead = 0;
+
+    /// \brief True if an archive is open.
+    bool _isOpen = false;
+
+};
+
+
+} // namespace ofx
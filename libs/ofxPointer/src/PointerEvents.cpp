@@ -6,7 +6,10 @@
 
 
 #include "ofx/PointerEvents.h"
+#include "ofx/PointerPredictor.h"
 #include <cassert>
+#include <mutex>
+#include <unordered_set>
 #include "ofGraphics.h"
 #include "ofMesh.h"
 
@@ -29,6 +32,18 @@ EventArgs::EventArgs(const void* eventSource,
                      const std::string& eventType,
                      uint64_t timestampMicros,
                      uint64_t detail):
+    EventArgs(eventSource,
+              _intern(eventType),
+              timestampMicros,
+              detail)
+{
+}
+
+
+EventArgs::EventArgs(const void* eventSource,
+                     const std::string* eventType,
+                     uint64_t timestampMicros,
+                     uint64_t detail):
     _eventSource(eventSource),
     _eventType(eventType),
     _timestampMicros(timestampMicros),
@@ -48,9 +63,9 @@ const void* EventArgs::eventSource() const
 }
 
 
-std::string EventArgs::eventType() const
+const std::string& EventArgs::eventType() const
 {
-    return _eventType;
+    return *_eventType;
 }
 
 
@@ -72,6 +87,46 @@ uint64_t EventArgs::detail() const
 }
 
 
+void EventArgs::_setEventType(const std::string* eventType)
+{
+    _eventType = eventType;
+}
+
+
+const std::string* EventArgs::_intern(const std::string& value,
+                                      const std::string& fallback)
+{
+    if (value == fallback)
+        return &fallback;
+
+    static std::mutex mutex;
+    static std::unordered_set<std::string> strings;
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    auto iter = strings.find(value);
+
+    // Elements of an unordered_set are never moved, so pointers are stable.
+    if (iter != strings.end())
+        return &*iter;
+
+    if (strings.size() >= MAX_INTERNED_STRINGS)
+    {
+        static bool isLogged = false;
+
+        if (!isLogged)
+        {
+            ofLogWarning("EventArgs::_intern") << "Too many custom types, using " << fallback << " instead.";
+            isLogged = true;
+        }
+
+        return &fallback;
+    }
+
+    return &*strings.insert(value).first;
+}
+
+
 PointShape::PointShape()
 {
 }
@@ -415,6 +470,231 @@ const std::string PointerEventArgs::PROPERTY_TILT_X = "PROPERTY_TILT_X";
 const std::string PointerEventArgs::PROPERTY_TILT_Y = "PROPERTY_TILT_Y";
 
 
+const std::string& to_string(PointerEventType v)
+{
+    switch (v)
+    {
+        case PointerEventType::UNKNOWN:
+            return EventArgs::EVENT_TYPE_UNKNOWN;
+        case PointerEventType::POINTER_OVER:
+            return PointerEventArgs::POINTER_OVER;
+        case PointerEventType::POINTER_ENTER:
+            return PointerEventArgs::POINTER_ENTER;
+        case PointerEventType::POINTER_DOWN:
+            return PointerEventArgs::POINTER_DOWN;
+        case PointerEventType::POINTER_MOVE:
+            return PointerEventArgs::POINTER_MOVE;
+        case PointerEventType::POINTER_UP:
+            return PointerEventArgs::POINTER_UP;
+        case PointerEventType::POINTER_CANCEL:
+            return PointerEventArgs::POINTER_CANCEL;
+        case PointerEventType::POINTER_UPDATE:
+            return PointerEventArgs::POINTER_UPDATE;
+        case PointerEventType::POINTER_OUT:
+            return PointerEventArgs::POINTER_OUT;
+        case PointerEventType::POINTER_LEAVE:
+            return PointerEventArgs::POINTER_LEAVE;
+        case PointerEventType::POINTER_SCROLL:
+            return PointerEventArgs::POINTER_SCROLL;
+        case PointerEventType::GOT_POINTER_CAPTURE:
+            return PointerEventArgs::GOT_POINTER_CAPTURE;
+        case PointerEventType::LOST_POINTER_CAPTURE:
+            return PointerEventArgs::LOST_POINTER_CAPTURE;
+    }
+
+    return EventArgs::EVENT_TYPE_UNKNOWN;
+}
+
+
+const std::string& to_string(PointerDeviceType v)
+{
+    switch (v)
+    {
+        case PointerDeviceType::UNKNOWN:
+            return PointerEventArgs::TYPE_UNKNOWN;
+        case PointerDeviceType::MOUSE:
+            return PointerEventArgs::TYPE_MOUSE;
+        case PointerDeviceType::PEN:
+            return PointerEventArgs::TYPE_PEN;
+        case PointerDeviceType::TOUCH:
+            return PointerEventArgs::TYPE_TOUCH;
+    }
+
+    return PointerEventArgs::TYPE_UNKNOWN;
+}
+
+
+PointerEventType toPointerEventType(const std::string& eventType)
+{
+    for (auto type: { PointerEventType::POINTER_MOVE,
+                      PointerEventType::POINTER_DOWN,
+                      PointerEventType::POINTER_UP,
+                      PointerEventType::POINTER_UPDATE,
+                      PointerEventType::POINTER_CANCEL,
+                      PointerEventType::POINTER_OVER,
+                      PointerEventType::POINTER_ENTER,
+                      PointerEventType::POINTER_OUT,
+                      PointerEventType::POINTER_LEAVE,
+                      PointerEventType::POINTER_SCROLL,
+                      PointerEventType::GOT_POINTER_CAPTURE,
+                      PointerEventType::LOST_POINTER_CAPTURE })
+    {
+        if (eventType == to_string(type))
+            return type;
+    }
+
+    return PointerEventType::UNKNOWN;
+}
+
+
+PointerDeviceType toPointerDeviceType(const std::string& deviceType)
+{
+    for (auto type: { PointerDeviceType::MOUSE,
+                      PointerDeviceType::PEN,
+                      PointerDeviceType::TOUCH })
+    {
+        if (deviceType == to_string(type))
+            return type;
+    }
+
+    return PointerDeviceType::UNKNOWN;
+}
+
+
+PointerPropertyMask toPointerPropertyMask(const std::set<std::string>& properties)
+{
+    PointerPropertyMask result = POINTER_PROPERTY_NONE;
+
+    for (const auto& property: properties)
+    {
+        if (property == PointerEventArgs::PROPERTY_POSITION)
+            result |= POINTER_PROPERTY_POSITION;
+        else if (property == PointerEventArgs::PROPERTY_PRESSURE)
+            result |= POINTER_PROPERTY_PRESSURE;
+        else if (property == PointerEventArgs::PROPERTY_TILT_X)
+            result |= POINTER_PROPERTY_TILT_X;
+        else if (property == PointerEventArgs::PROPERTY_TILT_Y)
+            result |= POINTER_PROPERTY_TILT_Y;
+        else
+            ofLogWarning("toPointerPropertyMask") << "Unknown property: " << property;
+    }
+
+    return result;
+}
+
+
+std::set<std::string> toPointerPropertyNames(PointerPropertyMask properties)
+{
+    std::set<std::string> result;
+
+    if (properties & POINTER_PROPERTY_POSITION)
+        result.insert(PointerEventArgs::PROPERTY_POSITION);
+
+    if (properties & POINTER_PROPERTY_PRESSURE)
+        result.insert(PointerEventArgs::PROPERTY_PRESSURE);
+
+    if (properties & POINTER_PROPERTY_TILT_X)
+        result.insert(PointerEventArgs::PROPERTY_TILT_X);
+
+    if (properties & POINTER_PROPERTY_TILT_Y)
+        result.insert(PointerEventArgs::PROPERTY_TILT_Y);
+
+    return result;
+}
+
+
+PointerSampleBuffer::PointerSampleBuffer()
+{
+}
+
+
+PointerSampleBuffer::PointerSampleBuffer(Span<PointerSample> samples)
+{
+    for (const auto& sample: samples)
+        push_back(sample);
+}
+
+
+void PointerSampleBuffer::push_back(const PointerSample& sample)
+{
+    if (_size < INLINE_CAPACITY)
+    {
+        _inline[_size] = sample;
+    }
+    else
+    {
+        // Move the inline samples to the heap to keep the samples contiguous.
+        if (_size == INLINE_CAPACITY)
+        {
+            _heap.clear();
+            _heap.insert(_heap.end(), _inline.begin(), _inline.end());
+        }
+
+        _heap.push_back(sample);
+    }
+
+    ++_size;
+}
+
+
+void PointerSampleBuffer::clear()
+{
+    _heap.clear();
+    _size = 0;
+}
+
+
+void PointerSampleBuffer::reserve(std::size_t numSamples)
+{
+    if (numSamples > INLINE_CAPACITY)
+        _heap.reserve(numSamples);
+}
+
+
+std::size_t PointerSampleBuffer::size() const
+{
+    return _size;
+}
+
+
+bool PointerSampleBuffer::empty() const
+{
+    return _size == 0;
+}
+
+
+PointerSample* PointerSampleBuffer::data()
+{
+    return _size > INLINE_CAPACITY ? _heap.data() : _inline.data();
+}
+
+
+const PointerSample* PointerSampleBuffer::data() const
+{
+    return _size > INLINE_CAPACITY ? _heap.data() : _inline.data();
+}
+
+
+Span<PointerSample> PointerSampleBuffer::samples() const
+{
+    return Span<PointerSample>(data(), _size);
+}
+
+
+/// \brief Convert legacy child events to samples.
+/// \param events The events to convert.
+/// \returns the converted samples.
+static PointerSampleBuffer toPointerSampleBuffer(const std::vector<PointerEventArgs>& events)
+{
+    PointerSampleBuffer result;
+
+    for (const auto& event: events)
+        result.push_back(event.toPointerSample());
+
+    return result;
+}
+
+
 PointerEventArgs::PointerEventArgs()
 {
 }
@@ -422,27 +702,20 @@ PointerEventArgs::PointerEventArgs()
 
 PointerEventArgs::PointerEventArgs(const std::string& eventType,
                                    const PointerEventArgs& event):
-    PointerEventArgs(event.eventSource(),
-                     eventType,
-                     event.timestampMicros(),
-                     event.detail(),
-                     event.point(),
-                     event.pointerId(),
-                     event.deviceId(),
-                     event.pointerIndex(),
-                     event.sequenceIndex(),
-                     event.deviceType(),
-                     event.isCoalesced(),
-                     event.isPredicted(),
-                     event.isPrimary(),
-                     event.button(),
-                     event.buttons(),
-                     event.modifiers(),
-                     event.coalescedPointerEvents(),
-                     event.predictedPointerEvents(),
-                     event.estimatedProperties(),
-                     event.estimatedPropertiesExpectingUpdates())
+    PointerEventArgs(toPointerEventType(eventType), event)
+{
+    // Preserve custom event types.
+    if (_pointerEventType == PointerEventType::UNKNOWN)
+        _setEventType(_intern(eventType));
+}
+
+
+PointerEventArgs::PointerEventArgs(PointerEventType eventType,
+                                   const PointerEventArgs& event):
+    PointerEventArgs(event)
 {
+    _pointerEventType = eventType;
+    _setEventType(&to_string(eventType));
 }
 
 
@@ -466,24 +739,102 @@ PointerEventArgs::PointerEventArgs(const void* eventSource,
                                    const std::vector<PointerEventArgs>& predictedPointerEvents,
                                    const std::set<std::string>& estimatedProperties,
                                    const std::set<std::string>& estimatedPropertiesExpectingUpdates):
-    EventArgs(eventSource, eventType, timestampMicros, detail),
+    PointerEventArgs(eventSource,
+                     toPointerEventType(eventType),
+                     timestampMicros,
+                     detail,
+                     point,
+                     pointerId,
+                     deviceId,
+                     pointerIndex,
+                     sequenceIndex,
+                     toPointerDeviceType(deviceType),
+                     isCoalesced,
+                     isPredicted,
+                     isPrimary,
+                     button,
+                     buttons,
+                     modifiers,
+                     toPointerSampleBuffer(coalescedPointerEvents).samples(),
+                     toPointerSampleBuffer(predictedPointerEvents).samples(),
+                     toPointerPropertyMask(estimatedProperties),
+                     toPointerPropertyMask(estimatedPropertiesExpectingUpdates))
+{
+    _preserveCustomTypes(eventType, deviceType);
+}
+
+
+PointerEventArgs::PointerEventArgs(const void* eventSource,
+                                   PointerEventType eventType,
+                                   uint64_t timestampMicros,
+                                   uint64_t detail,
+                                   const Point& point,
+                                   std::size_t pointerId,
+                                   int64_t deviceId,
+                                   int64_t pointerIndex,
+                                   uint64_t sequenceIndex,
+                                   PointerDeviceType deviceType,
+                                   bool isCoalesced,
+                                   bool isPredicted,
+                                   bool isPrimary,
+                                   int16_t button,
+                                   uint16_t buttons,
+                                   uint16_t modifiers,
+                                   Span<PointerSample> coalescedPointerEvents,
+                                   Span<PointerSample> predictedPointerEvents,
+                                   PointerPropertyMask estimatedProperties,
+                                   PointerPropertyMask estimatedPropertiesExpectingUpdates):
+    EventArgs(eventSource, &to_string(eventType), timestampMicros, detail),
     _point(point),
     _pointerId(pointerId),
     _deviceId(deviceId),
     _pointerIndex(pointerIndex),
     _sequenceIndex(sequenceIndex),
-    _deviceType(deviceType),
+    _pointerEventType(eventType),
+    _pointerDeviceType(deviceType),
+    _deviceType(&to_string(deviceType)),
     _isCoalesced(isCoalesced),
     _isPredicted(isPredicted),
     _isPrimary(isPrimary),
     _button(button),
     _buttons(buttons),
     _modifiers(modifiers),
-    _coalescedPointerEvents(coalescedPointerEvents),
-    _predictedPointerEvents(predictedPointerEvents),
+    _samples(coalescedPointerEvents),
+    _numCoalescedSamples(uint32_t(coalescedPointerEvents.size())),
     _estimatedProperties(estimatedProperties),
     _estimatedPropertiesExpectingUpdates(estimatedPropertiesExpectingUpdates)
 {
+    for (const auto& sample: predictedPointerEvents)
+        _samples.push_back(sample);
+}
+
+
+PointerEventArgs::PointerEventArgs(const PointerEventArgs& event,
+                                   const PointerSample& sample):
+    PointerEventArgs(event.eventSource(),
+                     event.pointerEventType(),
+                     sample.timestampMicros,
+                     event.detail(),
+                     sample.point,
+                     event.pointerId(),
+                     event.deviceId(),
+                     event.pointerIndex(),
+                     sample.sequenceIndex,
+                     event.pointerDeviceType(),
+                     sample.isCoalesced(),
+                     sample.isPredicted(),
+                     event.isPrimary(),
+                     event.button(),
+                     event.buttons(),
+                     event.modifiers(),
+                     {},
+                     {},
+                     sample.estimatedProperties,
+                     sample.estimatedPropertiesExpectingUpdates)
+{
+    // Preserve custom event and device type strings.
+    _setEventType(&event.eventType());
+    _deviceType = event._deviceType;
 }
 
 
@@ -492,6 +843,12 @@ PointerEventArgs::~PointerEventArgs()
 }
 
 
+PointerEventType PointerEventArgs::pointerEventType() const
+{
+    return _pointerEventType;
+}
+
+
 Point PointerEventArgs::point() const
 {
     return _point;
@@ -534,9 +891,15 @@ std::size_t PointerEventArgs::pointerId() const
 //}
 
 
-std::string PointerEventArgs::deviceType() const
+const std::string& PointerEventArgs::deviceType() const
+{
+    return *_deviceType;
+}
+
+
+PointerDeviceType PointerEventArgs::pointerDeviceType() const
 {
-    return _deviceType;
+    return _pointerDeviceType;
 }
 
 
@@ -560,7 +923,7 @@ bool PointerEventArgs::isPrimary() const
 
 bool PointerEventArgs::isEstimated() const
 {
-    return !_estimatedProperties.empty();
+    return _estimatedProperties != POINTER_PROPERTY_NONE;
 }
 
 
@@ -582,25 +945,46 @@ uint16_t PointerEventArgs::modifiers() const
 }
 
 
-std::vector<PointerEventArgs> PointerEventArgs::coalescedPointerEvents() const
+Span<PointerSample> PointerEventArgs::coalescedPointerEvents() const
+{
+    return Span<PointerSample>(_samples.data(), _numCoalescedSamples);
+}
+
+
+Span<PointerSample> PointerEventArgs::predictedPointerEvents() const
+{
+    return Span<PointerSample>(_samples.data() + _numCoalescedSamples,
+                               _samples.size() - _numCoalescedSamples);
+}
+
+
+void PointerEventArgs::reserveSamples(std::size_t numSamples)
 {
-    return _coalescedPointerEvents;
+    _samples.reserve(numSamples);
 }
 
 
-std::vector<PointerEventArgs> PointerEventArgs::predictedPointerEvents() const
+PointerSample PointerEventArgs::toPointerSample() const
 {
-    return _predictedPointerEvents;
+    PointerSample sample;
+    sample.point = _point;
+    sample.timestampMicros = timestampMicros();
+    sample.sequenceIndex = _sequenceIndex;
+    sample.flags = (_isCoalesced ? PointerSample::FLAG_COALESCED : PointerSample::FLAG_NONE)
+                 | (_isPredicted ? PointerSample::FLAG_PREDICTED : PointerSample::FLAG_NONE);
+    sample.estimatedProperties = _estimatedProperties;
+    sample.estimatedPropertiesExpectingUpdates = _estimatedPropertiesExpectingUpdates;
+    return sample;
 }
 
 
-std::set<std::string> PointerEventArgs::estimatedProperties() const
+PointerPropertyMask PointerEventArgs::estimatedProperties() const
 {
     return _estimatedProperties;
 }
 
 
-std::set<std::string> PointerEventArgs::estimatedPropertiesExpectingUpdates() const
+PointerPropertyMask PointerEventArgs::estimatedPropertiesExpectingUpdates() const
 {
     return _estimatedPropertiesExpectingUpdates;
 }
@@ -608,6 +992,16 @@ std::set<std::string> PointerEventArgs::estimatedPropertiesExpectingUpdates() co
 
 bool PointerEventArgs::updateEstimatedPropertiesWithEvent(const PointerEventArgs& e)
 {
+    PointerPropertyMask updatedProperties = POINTER_PROPERTY_NONE;
+    return updateEstimatedPropertiesWithEvent(e, updatedProperties);
+}
+
+
+bool PointerEventArgs::updateEstimatedPropertiesWithEvent(const PointerEventArgs& e,
+                                                          PointerPropertyMask& updatedProperties)
+{
+    updatedProperties = POINTER_PROPERTY_NONE;
+
     if (e.sequenceIndex() == 0 || sequenceIndex() == 0)
     {
         ofLogVerbose("PointerEventArgs::updateEstimatedPropertiesWithEvent") << "One or more of the sequence indices are zero.";
@@ -620,54 +1014,59 @@ bool PointerEventArgs::updateEstimatedPropertiesWithEvent(const PointerEventArgs
         return false;
     }
 
-    auto newEstimatedProperties = e.estimatedProperties();
-    std::vector<std::string> propertiesToUpdate;
+    // Properties that were expecting updates and are no longer estimated.
+    PointerPropertyMask propertiesToUpdate = _estimatedPropertiesExpectingUpdates & ~e._estimatedProperties;
 
-    std::set_difference(_estimatedPropertiesExpectingUpdates.begin(),
-                        _estimatedPropertiesExpectingUpdates.end(),
-                        newEstimatedProperties.begin(),
-                        newEstimatedProperties.end(),
-                        std::inserter(propertiesToUpdate, propertiesToUpdate.begin()));
+    if (propertiesToUpdate & POINTER_PROPERTY_PRESSURE)
+        _point._pressure = e._point._pressure;
 
-    for (auto& property: propertiesToUpdate)
+    if (propertiesToUpdate & POINTER_PROPERTY_TILT_X)
     {
-        if (property == PointerEventArgs::PROPERTY_PRESSURE)
-        {
-            _point._pressure = e.point().pressure();
-            ofNotifyEvent(pointerPropertyUpdate, property, this);
-        }
-        else if (property == PointerEventArgs::PROPERTY_TILT_X)
-        {
-            _point._tiltXDeg = e.point().tiltXDeg();
-            _point._azimuthAltitudeCached = false;
-            ofNotifyEvent(pointerPropertyUpdate, property, this);
-        }
-        else if (property == PointerEventArgs::PROPERTY_TILT_Y)
-        {
-            _point._tiltYDeg = e.point().tiltYDeg();
-            _point._azimuthAltitudeCached = false;
-            ofNotifyEvent(pointerPropertyUpdate, property, this);
-        }
-        else if (property == PointerEventArgs::PROPERTY_POSITION)
-        {
-            _point._position = e.point().position();
-            _point._precisePosition = e.point().precisePosition();
-            ofNotifyEvent(pointerPropertyUpdate, property, this);
-        }
-        else
-        {
-            ofLogWarning("PointerEventArgs::updateEstimatedPropertiesWithEvent") << "Unknown property to update: " << property;
-        }
+        _point._tiltXDeg = e._point._tiltXDeg;
+        _point._azimuthAltitudeCached = false;
+    }
+
+    if (propertiesToUpdate & POINTER_PROPERTY_TILT_Y)
+    {
+        _point._tiltYDeg = e._point._tiltYDeg;
+        _point._azimuthAltitudeCached = false;
+    }
 
-        _estimatedPropertiesExpectingUpdates.erase(property);
+    if (propertiesToUpdate & POINTER_PROPERTY_POSITION)
+    {
+        _point._position = e._point._position;
+        _point._precisePosition = e._point._precisePosition;
     }
 
+    _estimatedPropertiesExpectingUpdates &= ~propertiesToUpdate;
+
+    updatedProperties = propertiesToUpdate;
+
     return true;
 }
 
 
 PointerEventArgs PointerEventArgs::toPointerEventArgs(const void* eventSource,
                                                       const ofTouchEventArgs& e)
+{
+    uint16_t modifiers = 0;
+
+    modifiers |= ofGetKeyPressed(OF_KEY_CONTROL) ? OF_KEY_CONTROL : 0;
+    modifiers |= ofGetKeyPressed(OF_KEY_ALT)     ? OF_KEY_ALT     : 0;
+    modifiers |= ofGetKeyPressed(OF_KEY_SHIFT)   ? OF_KEY_SHIFT   : 0;
+    modifiers |= ofGetKeyPressed(OF_KEY_SUPER)   ? OF_KEY_SUPER   : 0;
+
+    return toPointerEventArgs(eventSource,
+                              e,
+                              ofGetElapsedTimeMicros(),
+                              modifiers);
+}
+
+
+PointerEventArgs PointerEventArgs::toPointerEventArgs(const void* eventSource,
+                                                      const ofTouchEventArgs& e,
+                                                      uint64_t timestampMicros,
+                                                      uint16_t modifiers)
 {
     // If major or minor axis is defined, then use them, otherwise, use width
     // and height. If neither are defined, use 1 and 1.
@@ -684,16 +1083,7 @@ PointerEventArgs PointerEventArgs::toPointerEventArgs(const void* eventSource,
                      0,
                      e.angle);
 
-    uint16_t modifiers = 0;
-
-    modifiers |= ofGetKeyPressed(OF_KEY_CONTROL) ? OF_KEY_CONTROL : 0;
-    modifiers |= ofGetKeyPressed(OF_KEY_ALT)     ? OF_KEY_ALT     : 0;
-    modifiers |= ofGetKeyPressed(OF_KEY_SHIFT)   ? OF_KEY_SHIFT   : 0;
-    modifiers |= ofGetKeyPressed(OF_KEY_SUPER)   ? OF_KEY_SUPER   : 0;
-
-    uint64_t timestampMicros = ofGetElapsedTimeMicros();
-
-    std::string eventType = EVENT_TYPE_UNKNOWN;
+    PointerEventType eventType = PointerEventType::UNKNOWN;
 
     uint64_t detail = 0;
 
@@ -711,18 +1101,18 @@ PointerEventArgs PointerEventArgs::toPointerEventArgs(const void* eventSource,
             // Pointers don't use this event. We use gestures for this.
             break;
         case ofTouchEventArgs::down:
-            eventType = POINTER_DOWN;
+            eventType = PointerEventType::POINTER_DOWN;
             buttons |= (1 << OF_MOUSE_BUTTON_1);
             break;
         case ofTouchEventArgs::up:
-            eventType = POINTER_UP;
+            eventType = PointerEventType::POINTER_UP;
             break;
         case ofTouchEventArgs::move:
             buttons |= (1 << OF_MOUSE_BUTTON_1);
-            eventType = POINTER_MOVE;
+            eventType = PointerEventType::POINTER_MOVE;
             break;
         case ofTouchEventArgs::cancel:
-            eventType = POINTER_CANCEL;
+            eventType = PointerEventType::POINTER_CANCEL;
             break;
     }
 
@@ -735,7 +1125,7 @@ PointerEventArgs PointerEventArgs::toPointerEventArgs(const void* eventSource,
 
     // Since we can't know for sure, we assume TOUCH because it came from a
     // ofTouchEventArgs.
-    std::string deviceType = PointerEventArgs::TYPE_TOUCH;
+    PointerDeviceType deviceType = PointerDeviceType::TOUCH;
 
     bool isCoalesced = false;
     bool isPredicted = false;
@@ -744,7 +1134,7 @@ PointerEventArgs PointerEventArgs::toPointerEventArgs(const void* eventSource,
     std::size_t pointerId = 0;
     hash_combine(pointerId, deviceId);
     hash_combine(pointerId, e.id);
-    hash_combine(pointerId, deviceType);
+    hash_combine(pointerId, to_string(deviceType));
 
     int64_t sequenceIndex = 0;
 
@@ -766,84 +1156,88 @@ PointerEventArgs PointerEventArgs::toPointerEventArgs(const void* eventSource,
                            modifiers,
                            {},
                            {},
-                           {},
-                           {});
-
-    return PointerEventArgs(eventSource,
-                            eventType,
-                            timestampMicros,
-                            detail,
-                            point,
-                            pointerId,
-                            deviceId,
-                            e.id,
-                            sequenceIndex,
-                            deviceType,
-                            isCoalesced,
-                            isPredicted,
-                            isPrimary,
-                            button,
-                            buttons,
-                            modifiers,
-                            { event },
-                            {},
-                            {},
-                            {});
+                           POINTER_PROPERTY_NONE,
+                           POINTER_PROPERTY_NONE);
+
+    // The coalesced samples include a copy of the current event.
+    event._samples.push_back(event.toPointerSample());
+    event._numCoalescedSamples = 1;
+
+    return event;
 }
 
 
 PointerEventArgs PointerEventArgs::toPointerEventArgs(const void* eventSource,
                                                       const ofMouseEventArgs& e)
 {
-    // We begin with an unknown event type.
-    std::string eventType = EVENT_TYPE_UNKNOWN;
-    uint64_t detail = 0;
+    // Calculate buttons.
+    uint16_t buttons = 0;
 
-    // Convert the ofMouseEventArgs type to a string event type.
-    switch (e.type)
-    {
-        case ofMouseEventArgs::Pressed:
-            eventType = POINTER_DOWN;
-            break;
-        case ofMouseEventArgs::Dragged:
-        case ofMouseEventArgs::Moved:
-            eventType = POINTER_MOVE;
-            break;
-        case ofMouseEventArgs::Released:
-            eventType = POINTER_UP;
-            break;
-        case ofMouseEventArgs::Scrolled:
-            eventType = POINTER_SCROLL;
-            break;
-        case ofMouseEventArgs::Entered:
-            // This is with respect to the source window.
-            eventType = POINTER_ENTER;
-            break;
+    buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_1) ? (1 << OF_MOUSE_BUTTON_1) : 0;
+    buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_2) ? (1 << OF_MOUSE_BUTTON_2) : 0;
+    buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_3) ? (1 << OF_MOUSE_BUTTON_3) : 0;
+    buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_4) ? (1 << OF_MOUSE_BUTTON_4) : 0;
+    buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_5) ? (1 << OF_MOUSE_BUTTON_5) : 0;
+    buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_6) ? (1 << OF_MOUSE_BUTTON_6) : 0;
+    buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_7) ? (1 << OF_MOUSE_BUTTON_7) : 0;
+
+    // Calculate modifiers.
+    uint16_t modifiers = 0;
+
+    modifiers |= ofGetKeyPressed(OF_KEY_CONTROL) ? OF_KEY_CONTROL : 0;
+    modifiers |= ofGetKeyPressed(OF_KEY_ALT)     ? OF_KEY_ALT     : 0;
+    modifiers |= ofGetKeyPressed(OF_KEY_SHIFT)   ? OF_KEY_SHIFT   : 0;
+    modifiers |= ofGetKeyPressed(OF_KEY_SUPER)   ? OF_KEY_SUPER   : 0;
+
+    return toPointerEventArgs(eventSource,
+                              e,
+                              ofGetElapsedTimeMicros(),
+                              buttons,
+                              modifiers);
+}
+
+
+PointerEventArgs PointerEventArgs::toPointerEventArgs(const void* eventSource,
+                                                      const ofMouseEventArgs& e,
+                                                      uint64_t timestampMicros,
+                                                      uint16_t buttons,
+                                                      uint16_t modifiers)
+{
+    // We begin with an unknown event type.
+    PointerEventType eventType = PointerEventType::UNKNOWN;
+    uint64_t detail = 0;
+
+    // Convert the ofMouseEventArgs type to a pointer event type.
+    switch (e.type)
+    {
+        case ofMouseEventArgs::Pressed:
+            eventType = PointerEventType::POINTER_DOWN;
+            break;
+        case ofMouseEventArgs::Dragged:
+        case ofMouseEventArgs::Moved:
+            eventType = PointerEventType::POINTER_MOVE;
+            break;
+        case ofMouseEventArgs::Released:
+            eventType = PointerEventType::POINTER_UP;
+            break;
+        case ofMouseEventArgs::Scrolled:
+            eventType = PointerEventType::POINTER_SCROLL;
+            break;
+        case ofMouseEventArgs::Entered:
+            // This is with respect to the source window.
+            eventType = PointerEventType::POINTER_ENTER;
+            break;
         case ofMouseEventArgs::Exited:
             // This is with respect to the source window.
-            eventType = POINTER_LEAVE;
+            eventType = PointerEventType::POINTER_LEAVE;
             break;
     }
 
-    // Record a timestamp.
-    uint64_t timestampMicros = ofGetElapsedTimeMicros();
-
     // TODO https://www.w3.org/TR/pointerevents/#the-button-property
     // This is not correctly implemented.
     // Note the mouse button associated with this event.
     int16_t button = -1;
 
-    // Calculate buttons.
-    uint16_t buttons = 0;
-
-    buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_1) ? (1 << OF_MOUSE_BUTTON_1) : 0;
-    buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_2) ? (1 << OF_MOUSE_BUTTON_2) : 0;
-    buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_3) ? (1 << OF_MOUSE_BUTTON_3) : 0;
-    buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_4) ? (1 << OF_MOUSE_BUTTON_4) : 0;
-    buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_5) ? (1 << OF_MOUSE_BUTTON_5) : 0;
-    buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_6) ? (1 << OF_MOUSE_BUTTON_6) : 0;
-    buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_7) ? (1 << OF_MOUSE_BUTTON_7) : 0;
-
     // Create the point, if a button is pressed, the pressure is 0.5.
     Point point(glm::vec2(e.x, e.y), PointShape(), (buttons > 0 ? 0.5 : 0));
 
@@ -851,24 +1245,16 @@ PointerEventArgs PointerEventArgs::toPointerEventArgs(const void* eventSource,
     bool isPredicted = false;
     bool isPrimary = true; // A mouse is primary.
 
-    // Calculate modifiers.
-    uint16_t modifiers = 0;
-
-    modifiers |= ofGetKeyPressed(OF_KEY_CONTROL) ? OF_KEY_CONTROL : 0;
-    modifiers |= ofGetKeyPressed(OF_KEY_ALT)     ? OF_KEY_ALT     : 0;
-    modifiers |= ofGetKeyPressed(OF_KEY_SHIFT)   ? OF_KEY_SHIFT   : 0;
-    modifiers |= ofGetKeyPressed(OF_KEY_SUPER)   ? OF_KEY_SUPER   : 0;
-
     std::size_t deviceId = 0;
     int64_t pointerIndex = 0;
     uint64_t sequenceIndex = 0;
 
-    std::string deviceType = PointerEventArgs::TYPE_MOUSE;
+    PointerDeviceType deviceType = PointerDeviceType::MOUSE;
 
     std::size_t pointerId = 0;
     hash_combine(pointerId, deviceId);
     hash_combine(pointerId, pointerIndex);
-    hash_combine(pointerId, deviceType);
+    hash_combine(pointerId, to_string(deviceType));
 
     PointerEventArgs event(eventSource,
                            eventType,
@@ -888,34 +1274,248 @@ PointerEventArgs PointerEventArgs::toPointerEventArgs(const void* eventSource,
                            modifiers,
                            {},
                            {},
-                           {},
-                           {});
-
-    return PointerEventArgs(eventSource,
-                            eventType,
-                            timestampMicros,
-                            detail,
-                            point,
-                            pointerId,
-                            deviceId,
-                            pointerIndex,
-                            sequenceIndex,
-                            deviceType,
-                            isCoalesced,
-                            isPredicted,
-                            isPrimary,
-                            button,
-                            buttons,
-                            modifiers,
-                            { event },
-                            {},
-                            {},
-                            {});
-}
-
-
-PointerEvents::PointerEvents(ofAppBaseWindow* source): _source(source)
+                           POINTER_PROPERTY_NONE,
+                           POINTER_PROPERTY_NONE);
+
+    // The coalesced samples include a copy of the current event.
+    event._samples.push_back(event.toPointerSample());
+    event._numCoalescedSamples = 1;
+
+    return event;
+}
+
+
+PointerEventArgs PointerEventArgs::toPointerEventArgs(const void* eventSource,
+                                                      const std::string& eventType,
+                                                      uint64_t timestampMicros,
+                                                      uint64_t detail,
+                                                      const Point& point,
+                                                      std::size_t pointerId,
+                                                      int64_t deviceId,
+                                                      int64_t pointerIndex,
+                                                      uint64_t sequenceIndex,
+                                                      const std::string& deviceType,
+                                                      bool isCoalesced,
+                                                      bool isPredicted,
+                                                      bool isPrimary,
+                                                      int16_t button,
+                                                      uint16_t buttons,
+                                                      uint16_t modifiers,
+                                                      Span<PointerSample> coalescedPointerEvents,
+                                                      Span<PointerSample> predictedPointerEvents,
+                                                      PointerPropertyMask estimatedProperties,
+                                                      PointerPropertyMask estimatedPropertiesExpectingUpdates)
+{
+    PointerEventArgs event(eventSource,
+                           toPointerEventType(eventType),
+                           timestampMicros,
+                           detail,
+                           point,
+                           pointerId,
+                           deviceId,
+                           pointerIndex,
+                           sequenceIndex,
+                           toPointerDeviceType(deviceType),
+                           isCoalesced,
+                           isPredicted,
+                           isPrimary,
+                           button,
+                           buttons,
+                           modifiers,
+                           coalescedPointerEvents,
+                           predictedPointerEvents,
+                           estimatedProperties,
+                           estimatedPropertiesExpectingUpdates);
+
+    event._preserveCustomTypes(eventType, deviceType);
+
+    return event;
+}
+
+
+void PointerEventArgs::_preserveCustomTypes(const std::string& eventType,
+                                            const std::string& deviceType)
+{
+    if (_pointerEventType == PointerEventType::UNKNOWN)
+        _setEventType(_intern(eventType));
+
+    if (_pointerDeviceType == PointerDeviceType::UNKNOWN)
+        _deviceType = _intern(deviceType, TYPE_UNKNOWN);
+}
+
+
+PointerClock::~PointerClock()
+{
+}
+
+
+uint64_t PointerClock::timestampMicrosForAge(uint64_t ageMicros) const
+{
+    uint64_t now = nowMicros();
+    return now > ageMicros ? now - ageMicros : 0;
+}
+
+
+std::shared_ptr<PointerClock> PointerClock::defaultClock()
+{
+    static std::shared_ptr<PointerClock> clock = std::make_shared<SteadyPointerClock>();
+    return clock;
+}
+
+
+SteadyPointerClock::SteadyPointerClock():
+    SteadyPointerClock(std::chrono::steady_clock::now() - std::chrono::microseconds(ofGetElapsedTimeMicros()))
+{
+}
+
+
+SteadyPointerClock::SteadyPointerClock(std::chrono::steady_clock::time_point origin):
+    _origin(origin)
+{
+}
+
+
+SteadyPointerClock::~SteadyPointerClock()
+{
+}
+
+
+uint64_t SteadyPointerClock::nowMicros() const
+{
+    return toMicros(std::chrono::steady_clock::now());
+}
+
+
+uint64_t SteadyPointerClock::toMicros(std::chrono::steady_clock::time_point timePoint) const
+{
+    if (timePoint < _origin)
+        return 0;
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(timePoint - _origin).count();
+}
+
+
+ManualPointerClock::ManualPointerClock(uint64_t micros): _micros(micros)
+{
+}
+
+
+ManualPointerClock::~ManualPointerClock()
 {
+}
+
+
+uint64_t ManualPointerClock::nowMicros() const
+{
+    return _micros.load();
+}
+
+
+void ManualPointerClock::setMicros(uint64_t micros)
+{
+    _micros.store(micros);
+}
+
+
+void ManualPointerClock::advanceMicros(uint64_t micros)
+{
+    _micros.fetch_add(micros);
+}
+
+
+PointerEventQueue::PointerEventQueue(std::size_t capacity)
+{
+    std::size_t size = 2;
+
+    while (size < capacity)
+        size *= 2;
+
+    _cells.reset(new Cell[size]);
+    _mask = size - 1;
+
+    for (std::size_t i = 0; i < size; ++i)
+        _cells[i].sequence.store(i, std::memory_order_relaxed);
+
+    _pushPosition.store(0, std::memory_order_relaxed);
+    _popPosition.store(0, std::memory_order_relaxed);
+}
+
+
+PointerEventQueue::~PointerEventQueue()
+{
+}
+
+
+bool PointerEventQueue::push(const PointerEventArgs& e)
+{
+    // A bounded multi-producer queue after Dmitry Vyukov. Each slot's sequence
+    // equals the position when it is free to push and position + 1 when it is
+    // ready to pop.
+    Cell* cell = nullptr;
+    std::size_t position = _pushPosition.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        cell = &_cells[position & _mask];
+        std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        std::ptrdiff_t difference = std::ptrdiff_t(sequence) - std::ptrdiff_t(position);
+
+        if (difference == 0)
+        {
+            if (_pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0)
+        {
+            // The queue is full.
+            return false;
+        }
+        else
+        {
+            position = _pushPosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->event = e;
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+
+bool PointerEventQueue::pop(PointerEventArgs& e)
+{
+    std::size_t position = _popPosition.load(std::memory_order_relaxed);
+    Cell* cell = &_cells[position & _mask];
+    std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+
+    if (std::ptrdiff_t(sequence) - std::ptrdiff_t(position + 1) < 0)
+        return false;
+
+    _popPosition.store(position + 1, std::memory_order_relaxed);
+
+    e = std::move(cell->event);
+    cell->sequence.store(position + _mask + 1, std::memory_order_release);
+    return true;
+}
+
+
+std::size_t PointerEventQueue::capacity() const
+{
+    return _mask + 1;
+}
+
+
+PointerEvents::PointerEvents(ofAppBaseWindow* source):
+    _clock(PointerClock::defaultClock()),
+    _source(source)
+{
+    _eventsForType.fill(nullptr);
+    _eventsForType[static_cast<std::size_t>(PointerEventType::POINTER_DOWN)] = &pointerDown;
+    _eventsForType[static_cast<std::size_t>(PointerEventType::POINTER_UP)] = &pointerUp;
+    _eventsForType[static_cast<std::size_t>(PointerEventType::POINTER_MOVE)] = &pointerMove;
+    _eventsForType[static_cast<std::size_t>(PointerEventType::POINTER_CANCEL)] = &pointerCancel;
+    _eventsForType[static_cast<std::size_t>(PointerEventType::POINTER_UPDATE)] = &pointerUpdate;
+
     ofCoreEvents* eventSource = nullptr;
 
     if (_source)
@@ -941,6 +1541,9 @@ PointerEvents::PointerEvents(ofAppBaseWindow* source): _source(source)
     _touchMovedListener = eventSource->touchMoved.newListener(this, &PointerEvents::onTouchEvent, OF_EVENT_ORDER_BEFORE_APP);
     _touchDoubleTapListener = eventSource->touchDoubleTap.newListener(this, &PointerEvents::onTouchEvent, OF_EVENT_ORDER_BEFORE_APP);
     _touchCancelledListener = eventSource->touchCancelled.newListener(this, &PointerEvents::onTouchEvent, OF_EVENT_ORDER_BEFORE_APP);
+    _updateListener = eventSource->update.newListener(this, &PointerEvents::onUpdate, OF_EVENT_ORDER_BEFORE_APP);
+    _keyPressedListener = eventSource->keyPressed.newListener(this, &PointerEvents::onKeyEvent, OF_EVENT_ORDER_BEFORE_APP);
+    _keyReleasedListener = eventSource->keyReleased.newListener(this, &PointerEvents::onKeyEvent, OF_EVENT_ORDER_BEFORE_APP);
 
 }
 
@@ -958,9 +1561,24 @@ bool PointerEvents::onPointerEvent(const void* source, PointerEventArgs& e)
 
 bool PointerEvents::onMouseEvent(const void* source, ofMouseEventArgs& e)
 {
+    // Track the pressed buttons. The button state includes the button of the
+    // current pressed event and excludes the button of the current released
+    // event.
+    if (e.button >= 0 && e.button < 16)
+    {
+        if (e.type == ofMouseEventArgs::Pressed)
+            _buttons |= (1 << e.button);
+        else if (e.type == ofMouseEventArgs::Released)
+            _buttons &= ~(1 << e.button);
+    }
+
     // We use _source here because ofMouseEventArgs events aren't currently
     // delivered with a source.
-    auto p = PointerEventArgs::toPointerEventArgs(_source, e);
+    auto p = PointerEventArgs::toPointerEventArgs(_source,
+                                                  e,
+                                                  _clock->nowMicros(),
+                                                  _buttons,
+                                                  _modifiers);
     return _dispatchPointerEvent(source, p);
 }
 
@@ -969,599 +1587,2289 @@ bool PointerEvents::onTouchEvent(const void* source, ofTouchEventArgs& e)
 {
     // We use _source here because ofTouchEventArgs events aren't currently
     // delivered with a source.
-    auto p = PointerEventArgs::toPointerEventArgs(_source, e);
+    auto p = PointerEventArgs::toPointerEventArgs(_source,
+                                                  e,
+                                                  _clock->nowMicros(),
+                                                  _modifiers);
     return _dispatchPointerEvent(source, p);
 }
 
 
-//void PointerEvents::disableLegacyEvents()
-//{
-//    _consumeLegacyEvents = true;
-//}
-//
-//
-//void PointerEvents::enableLegacyEvents()
-//{
-//    _consumeLegacyEvents = false;
-//}
-
-
-bool PointerEvents::_dispatchPointerEvent(const void* source, PointerEventArgs& e)
+bool PointerEvents::onKeyEvent(const void* source, ofKeyEventArgs& e)
 {
-    // TODO: Update this when openFrameworks core supports source on events.
-    if (source && source != _source)
-    {
-        // "Event source sent, but does not match window. PointerEvents should be updated to respect source."
-        assert(false);
-        ofLogError("PointerEvents::_dispatchPointerEvent") << "Mismatched source.";
-        return false;
-    }
+    // The left and right modifier keys, indexed by their bit in _modifierKeys.
+    static const std::array<int, 8> MODIFIER_KEYS =
+    {{
+        OF_KEY_LEFT_CONTROL,
+        OF_KEY_RIGHT_CONTROL,
+        OF_KEY_LEFT_ALT,
+        OF_KEY_RIGHT_ALT,
+        OF_KEY_LEFT_SHIFT,
+        OF_KEY_RIGHT_SHIFT,
+        OF_KEY_LEFT_SUPER,
+        OF_KEY_RIGHT_SUPER
+    }};
 
-    if (e.eventType() == PointerEventArgs::EVENT_TYPE_UNKNOWN)
+    for (std::size_t i = 0; i < MODIFIER_KEYS.size(); ++i)
     {
-        // We don't deliver unknown event types.
-        // These are usually double-tap events from OF core.
-        return true;
-    }
+        if (e.key == MODIFIER_KEYS[i])
+        {
+            if (e.type == ofKeyEventArgs::Pressed)
+                _modifierKeys |= (1 << i);
+            else
+                _modifierKeys &= ~(1 << i);
 
-    // All pointer events get dispatched via pointerEvent.
-    bool consumed = ofNotifyEvent(pointerEvent, e, _source);
+            // Either the left or right key sets the generic modifier, e.g.
+            // OF_KEY_LEFT_SHIFT sets OF_KEY_SHIFT.
+            _modifiers = 0;
 
-    // If the pointer was not consumed, then send it along to the standard five.
-    if (!consumed)
-    {
-        if (e.eventType() == PointerEventArgs::POINTER_DOWN)
-        {
-            consumed = ofNotifyEvent(pointerDown, e, _source);
-        }
-        else if (e.eventType() == PointerEventArgs::POINTER_UP)
-        {
-            consumed = ofNotifyEvent(pointerUp, e, _source);
-        }
-        else if (e.eventType() == PointerEventArgs::POINTER_MOVE)
-        {
-            consumed = ofNotifyEvent(pointerMove, e, _source);
-        }
-        else if (e.eventType() == PointerEventArgs::POINTER_CANCEL)
-        {
-            consumed = ofNotifyEvent(pointerCancel, e, _source);
-        }
-        else if (e.eventType() == PointerEventArgs::POINTER_UPDATE)
-        {
-            consumed = ofNotifyEvent(pointerUpdate, e, _source);
+            for (std::size_t j = 0; j < MODIFIER_KEYS.size(); ++j)
+            {
+                if (_modifierKeys & (1 << j))
+                    _modifiers |= (MODIFIER_KEYS[j] & ~0x3);
+            }
+
+            break;
         }
     }
 
-    return _consumeLegacyEvents || consumed;
+    return false;
+}
+
+
+void PointerEvents::onUpdate(ofEventArgs& e)
+{
+    if (_autoDrain)
+        drain();
+
+    flushCoalescedMoves();
+
+    _notifyPointerFrame();
+}
+
+
+void PointerEvents::setCoalesceMoves(bool coalesceMoves)
+{
+    if (!coalesceMoves)
+        flushCoalescedMoves();
+
+    _coalesceMoves = coalesceMoves;
+}
+
+
+bool PointerEvents::getCoalesceMoves() const
+{
+    return _coalesceMoves;
+}
+
+
+void PointerEvents::flushCoalescedMoves()
+{
+    if (_pendingMoves.empty())
+        return;
+
+    // Listeners may generate new events, so take the pending moves first.
+    std::map<std::size_t, PointerEventArgs> pendingMoves;
+    std::swap(pendingMoves, _pendingMoves);
+
+    for (auto& pendingMove: pendingMoves)
+        _notifyPointerEvent(pendingMove.second);
+}
+
+
+bool PointerEvents::enqueuePointerEvent(const PointerEventArgs& e)
+{
+    std::call_once(_queueOnceFlag, [this]() {
+        _queue = std::make_unique<PointerEventQueue>(_queueCapacity);
+    });
+
+    ++_numEnqueuedEvents;
+
+    if (_queue->push(e))
+        return true;
+
+    ++_numDroppedEvents;
+    return false;
+}
+
+
+std::size_t PointerEvents::drain()
+{
+    // The queue is only created by the first enqueue. Events queued after
+    // this check are drained next time.
+    if (_numEnqueuedEvents.load() == 0)
+        return 0;
+
+    std::size_t count = 0;
+    PointerEventArgs e;
+
+    while (_queue->pop(e))
+    {
+        _dispatchPointerEvent(nullptr, e);
+        ++count;
+    }
+
+    return count;
+}
+
+
+void PointerEvents::setAutoDrain(bool autoDrain)
+{
+    _autoDrain = autoDrain;
+}
+
+
+bool PointerEvents::getAutoDrain() const
+{
+    return _autoDrain;
+}
+
+
+void PointerEvents::setQueueCapacity(std::size_t capacity)
+{
+    _queueCapacity = capacity;
+}
+
+
+uint64_t PointerEvents::numEnqueuedEvents() const
+{
+    return _numEnqueuedEvents.load();
+}
+
+
+uint64_t PointerEvents::numDroppedEvents() const
+{
+    return _numDroppedEvents.load();
+}
+
+
+void PointerEvents::setPredictor(std::shared_ptr<PointerPredictor> predictor)
+{
+    _predictor = predictor;
+}
+
+
+std::shared_ptr<PointerPredictor> PointerEvents::getPredictor() const
+{
+    return _predictor;
+}
+
+
+uint16_t PointerEvents::modifiers() const
+{
+    return _modifiers;
+}
+
+
+uint16_t PointerEvents::buttons() const
+{
+    return _buttons;
+}
+
+
+void PointerEvents::setClock(std::shared_ptr<PointerClock> clock)
+{
+    _clock = clock ? clock : PointerClock::defaultClock();
+}
+
+
+std::shared_ptr<PointerClock> PointerEvents::clock() const
+{
+    return _clock;
+}
+
+
+//void PointerEvents::disableLegacyEvents()
+//{
+//    _consumeLegacyEvents = true;
+//}
+//
+//
+//void PointerEvents::enableLegacyEvents()
+//{
+//    _consumeLegacyEvents = false;
+//}
+
+
+bool PointerEvents::_dispatchPointerEvent(const void* source, PointerEventArgs& e)
+{
+    // TODO: Update this when openFrameworks core supports source on events.
+    if (source && source != _source)
+    {
+        // "Event source sent, but does not match window. PointerEvents should be updated to respect source."
+        assert(false);
+        ofLogError("PointerEvents::_dispatchPointerEvent") << "Mismatched source.";
+        return false;
+    }
+
+    if (e.pointerEventType() == PointerEventType::UNKNOWN
+    &&  e.eventType() == PointerEventArgs::EVENT_TYPE_UNKNOWN)
+    {
+        // We don't deliver unknown event types.
+        // These are usually double-tap events from OF core.
+        return true;
+    }
+
+    if (_coalesceMoves)
+    {
+        if (e.pointerEventType() == PointerEventType::POINTER_MOVE)
+        {
+            _coalesceMove(e);
+            return _consumeLegacyEvents;
+        }
+
+        // Keep the pointer's events in order.
+        _flushCoalescedMove(e.pointerId());
+    }
+
+    return _notifyPointerEvent(e);
+}
+
+
+bool PointerEvents::_notifyPointerEvent(PointerEventArgs& e)
+{
+    if (_predictor)
+    {
+        _predictor->add(e);
+
+        // Platform-supplied predictions are preferred.
+        if (e.pointerEventType() == PointerEventType::POINTER_MOVE
+        &&  e.predictedPointerEvents().empty())
+        {
+            // Predicted samples follow the coalesced samples.
+            _predictor->predict(e, e._samples);
+        }
+    }
+
+    if (pointerFrame.size() > 0)
+    {
+        _frame.events.push_back(e);
+
+        switch (e.pointerEventType())
+        {
+            case PointerEventType::POINTER_UP:
+            case PointerEventType::POINTER_CANCEL:
+            case PointerEventType::POINTER_OUT:
+            case PointerEventType::POINTER_LEAVE:
+                _activePointers.erase(e.pointerId());
+                break;
+            case PointerEventType::POINTER_UPDATE:
+                // Updates only carry the updated properties.
+                break;
+            default:
+                _activePointers[e.pointerId()] = e;
+                break;
+        }
+    }
+
+    // All pointer events get dispatched via pointerEvent.
+    bool consumed = ofNotifyEvent(pointerEvent, e, _source);
+
+    // If the pointer was not consumed, then send it along to the standard five.
+    if (!consumed)
+    {
+        std::size_t type = static_cast<std::size_t>(e.pointerEventType());
+        auto event = type < _eventsForType.size() ? _eventsForType[type] : nullptr;
+
+        if (event)
+            consumed = ofNotifyEvent(*event, e, _source);
+    }
+
+    return _consumeLegacyEvents || consumed;
+}
+
+
+void PointerEvents::_notifyPointerFrame()
+{
+    // Forget the active pointers if the listeners have been removed.
+    if (pointerFrame.size() == 0)
+    {
+        _frame.events.clear();
+        _activePointers.clear();
+        return;
+    }
+
+    if (_frame.events.empty() && _activePointers.empty())
+        return;
+
+    _frame.timestampMicros = _clock->nowMicros();
+
+    _frame.activePointers.clear();
+    for (const auto& activePointer: _activePointers)
+        _frame.activePointers.push_back(activePointer.second);
+
+    ofNotifyEvent(pointerFrame, _frame, _source);
+
+    // Keep the allocated capacity for the next frame.
+    _frame.events.clear();
+}
+
+
+void PointerEvents::_coalesceMove(const PointerEventArgs& e)
+{
+    auto iter = _pendingMoves.find(e.pointerId());
+
+    if (iter == _pendingMoves.end())
+    {
+        _pendingMoves.insert(std::make_pair(e.pointerId(), e));
+        return;
+    }
+
+    // The buffered samples, including the buffered event, are now coalesced.
+    PointerSampleBuffer samples(iter->second.coalescedPointerEvents());
+
+    for (std::size_t i = 0; i < samples.size(); ++i)
+        samples.data()[i].flags |= PointerSample::FLAG_COALESCED;
+
+    for (const auto& sample: e.coalescedPointerEvents())
+        samples.push_back(sample);
+
+    uint32_t numCoalescedSamples = uint32_t(samples.size());
+
+    // The latest event replaces the buffered event, along with its predictions.
+    for (const auto& sample: e.predictedPointerEvents())
+        samples.push_back(sample);
+
+    iter->second = e;
+    iter->second._samples = samples;
+    iter->second._numCoalescedSamples = numCoalescedSamples;
+}
+
+
+void PointerEvents::_flushCoalescedMove(std::size_t pointerId)
+{
+    auto iter = _pendingMoves.find(pointerId);
+
+    if (iter != _pendingMoves.end())
+    {
+        PointerEventArgs pendingMove = iter->second;
+        _pendingMoves.erase(iter);
+        _notifyPointerEvent(pendingMove);
+    }
+}
+
+
+PointerEvents* PointerEventsManager::events()
+{
+    return eventsForWindow(nullptr);
+}
+
+
+PointerEvents* PointerEventsManager::eventsForWindow(ofAppBaseWindow* window)
+{
+    auto iter = _windowEventMap.find(window);
+
+    if (iter != _windowEventMap.end())
+    {
+        return iter->second.get();
+    }
+
+    _windowEventMap[window] = std::make_unique<PointerEvents>(window);
+    return _windowEventMap[window].get();
+}
+
+
+PointerEventsManager& PointerEventsManager::instance()
+{
+    static PointerEventsManager instance;
+    return instance;
+}
+
+
+PointerEventsManager::PointerEventsManager()
+{
+}
+
+
+PointerEventsManager::~PointerEventsManager()
+{
+}
+
+
+
+void PointerStrokeData::add(const PointerEventArgs& e)
+{
+    const Point& point = e.point();
+
+    _positions.push_back(point.position());
+    _pressures.push_back(point.pressure());
+    _tiltsDeg.push_back(glm::vec2(point.tiltXDeg(), point.tiltYDeg()));
+    _timestampsMicros.push_back(e.timestampMicros());
+    _flags.push_back((e.isCoalesced() ? PointerSample::FLAG_COALESCED : PointerSample::FLAG_NONE)
+                   | (e.isPredicted() ? PointerSample::FLAG_PREDICTED : PointerSample::FLAG_NONE));
+}
+
+
+void PointerStrokeData::set(std::size_t index, const PointerEventArgs& e)
+{
+    const Point& point = e.point();
+
+    _positions[index] = point.position();
+    _pressures[index] = point.pressure();
+    _tiltsDeg[index] = glm::vec2(point.tiltXDeg(), point.tiltYDeg());
+    _timestampsMicros[index] = e.timestampMicros();
+    _flags[index] = (e.isCoalesced() ? PointerSample::FLAG_COALESCED : PointerSample::FLAG_NONE)
+                  | (e.isPredicted() ? PointerSample::FLAG_PREDICTED : PointerSample::FLAG_NONE);
+}
+
+
+void PointerStrokeData::resize(std::size_t size)
+{
+    _positions.resize(size);
+    _pressures.resize(size);
+    _tiltsDeg.resize(size);
+    _timestampsMicros.resize(size);
+    _flags.resize(size);
+}
+
+
+void PointerStrokeData::reserve(std::size_t size)
+{
+    _positions.reserve(size);
+    _pressures.reserve(size);
+    _tiltsDeg.reserve(size);
+    _timestampsMicros.reserve(size);
+    _flags.reserve(size);
+}
+
+
+void PointerStrokeData::clear()
+{
+    _positions.clear();
+    _pressures.clear();
+    _tiltsDeg.clear();
+    _timestampsMicros.clear();
+    _flags.clear();
+}
+
+
+std::size_t PointerStrokeData::size() const
+{
+    return _positions.size();
+}
+
+
+bool PointerStrokeData::empty() const
+{
+    return _positions.empty();
+}
+
+
+const std::vector<glm::vec2>& PointerStrokeData::positions() const
+{
+    return _positions;
+}
+
+
+const std::vector<float>& PointerStrokeData::pressures() const
+{
+    return _pressures;
+}
+
+
+const std::vector<glm::vec2>& PointerStrokeData::tiltsDeg() const
+{
+    return _tiltsDeg;
+}
+
+
+const std::vector<uint64_t>& PointerStrokeData::timestampsMicros() const
+{
+    return _timestampsMicros;
+}
+
+
+const std::vector<uint8_t>& PointerStrokeData::flags() const
+{
+    return _flags;
+}
+
+
+PointerStroke::PointerStroke()
+{
+}
+
+
+PointerStroke::~PointerStroke()
+{
+}
+
+
+bool PointerStroke::add(const PointerEventArgs& e)
+{
+    if (_events.empty())
+        _pointerId = e.pointerId();
+
+    if (_pointerId != e.pointerId())
+        return false;
+
+    if (e.pointerEventType() == PointerEventType::POINTER_UPDATE)
+    {
+        auto iter = _pendingUpdates.find(e.sequenceIndex());
+
+        if (iter == _pendingUpdates.end())
+            return false;
+
+        PointerEventArgs& event = _events[iter->second];
+
+        PointerPropertyUpdateEventArgs args;
+        args.pointerId = _pointerId;
+        args.sequenceIndex = e.sequenceIndex();
+
+        if (!event.updateEstimatedPropertiesWithEvent(e, args.updatedProperties))
+            ofLogError("PointerStroke::add") << "Error updating matching property.";
+
+        _modifiedIndex = iter->second;
+        _numModifiedEvents = 0;
+
+        if (args.updatedProperties != POINTER_PROPERTY_NONE)
+        {
+            _updateStatistics(iter->second, event);
+            _data.set(iter->second, event);
+            _numModifiedEvents = 1;
+        }
+
+        if (event.estimatedPropertiesExpectingUpdates() == POINTER_PROPERTY_NONE)
+        {
+            _pendingUpdates.erase(iter);
+            --_numExpectingUpdates;
+        }
+
+        if (args.updatedProperties != POINTER_PROPERTY_NONE)
+            ofNotifyEvent(pointerPropertyUpdate, args, this);
+
+        return true;
+    }
+
+    // Remove the predicted events from the tail.
+    _events.resize(_events.size() - _numPredictedEvents);
+    _data.resize(_events.size());
+    _numPredictedEvents = 0;
+    _modifiedIndex = _events.size();
+
+    // Add coalesced events, this includes the current event.
+    auto coalesced = e.coalescedPointerEvents();
+    for (const auto& sample: coalesced)
+        _addMeasured(PointerEventArgs(e, sample));
+
+    if (coalesced.empty())
+        ofLogError("PointerStroke::add") << "No coalesced events!";
+
+    // Add predicted events.
+    for (const auto& sample: e.predictedPointerEvents())
+    {
+        _events.push_back(PointerEventArgs(e, sample));
+        _data.add(_events.back());
+    }
+
+    _numPredictedEvents = e.predictedPointerEvents().size();
+    _numModifiedEvents = _events.size() - _modifiedIndex;
+
+    _minSequenceIndex = std::min(e.sequenceIndex(), _minSequenceIndex);
+    _maxSequenceIndex = std::max(e.sequenceIndex(), _maxSequenceIndex);
+
+    return true;
+}
+
+
+void PointerStroke::_addMeasured(const PointerEventArgs& e)
+{
+    if (e.estimatedPropertiesExpectingUpdates() != POINTER_PROPERTY_NONE)
+    {
+        ++_numExpectingUpdates;
+
+        // Events without a sequence index can't be matched with updates.
+        if (e.sequenceIndex() != 0)
+        {
+            auto result = _pendingUpdates.insert(std::make_pair(e.sequenceIndex(), _events.size()));
+
+            // Updates are matched with the most recent event.
+            if (!result.second)
+                result.first->second = _events.size();
+        }
+    }
+
+    // The predicted events have been removed, so the previous event is measured.
+    if (!_data.empty())
+        _arcLength += glm::distance(_data.positions().back(), e.position());
+
+    if (!_extremaInvalid)
+        _expandExtrema(e.position(), e.point().pressure(), e.timestampMicros());
+
+    _events.push_back(e);
+    _data.add(e);
+}
+
+
+void PointerStroke::_updateStatistics(std::size_t index, const PointerEventArgs& e)
+{
+    const auto& positions = _data.positions();
+    std::size_t numMeasured = _numMeasuredEvents();
+
+    glm::vec2 oldPosition = positions[index];
+    glm::vec2 newPosition = e.position();
+    float oldPressure = _data.pressures()[index];
+    float newPressure = e.point().pressure();
+    uint64_t oldTimestampMicros = _data.timestampsMicros()[index];
+    uint64_t newTimestampMicros = e.timestampMicros();
+
+    if (oldPosition != newPosition)
+    {
+        if (index > 0)
+        {
+            _arcLength -= glm::distance(positions[index - 1], oldPosition);
+            _arcLength += glm::distance(positions[index - 1], newPosition);
+        }
+
+        if (index + 1 < numMeasured)
+        {
+            _arcLength -= glm::distance(oldPosition, positions[index + 1]);
+            _arcLength += glm::distance(newPosition, positions[index + 1]);
+        }
+    }
+
+    if (_extremaInvalid)
+        return;
+
+    if (oldPosition.x == _minPosition.x || oldPosition.x == _maxPosition.x
+     || oldPosition.y == _minPosition.y || oldPosition.y == _maxPosition.y
+     || oldPressure == _minPressure || oldPressure == _maxPressure
+     || oldTimestampMicros == _minTimestampMicros
+     || oldTimestampMicros == _maxTimestampMicros)
+    {
+        _extremaInvalid = true;
+        return;
+    }
+
+    _expandExtrema(newPosition, newPressure, newTimestampMicros);
+}
+
+
+void PointerStroke::_expandExtrema(const glm::vec2& position,
+                                   float pressure,
+                                   uint64_t timestampMicros) const
+{
+    _minPosition = glm::min(_minPosition, position);
+    _maxPosition = glm::max(_maxPosition, position);
+    _minPressure = std::min(_minPressure, pressure);
+    _maxPressure = std::max(_maxPressure, pressure);
+    _minTimestampMicros = std::min(_minTimestampMicros, timestampMicros);
+    _maxTimestampMicros = std::max(_maxTimestampMicros, timestampMicros);
+}
+
+
+void PointerStroke::_validateExtrema() const
+{
+    if (!_extremaInvalid)
+        return;
+
+    _minPosition = glm::vec2(std::numeric_limits<float>::max());
+    _maxPosition = glm::vec2(std::numeric_limits<float>::lowest());
+    _minPressure = std::numeric_limits<float>::max();
+    _maxPressure = std::numeric_limits<float>::lowest();
+    _minTimestampMicros = std::numeric_limits<uint64_t>::max();
+    _maxTimestampMicros = 0;
+
+    const auto& positions = _data.positions();
+    const auto& pressures = _data.pressures();
+    const auto& timestamps = _data.timestampsMicros();
+    std::size_t numMeasured = _numMeasuredEvents();
+
+    for (std::size_t i = 0; i < numMeasured; ++i)
+        _expandExtrema(positions[i], pressures[i], timestamps[i]);
+
+    _extremaInvalid = false;
+}
+
+
+std::size_t PointerStroke::_numMeasuredEvents() const
+{
+    return _events.size() - _numPredictedEvents;
+}
+
+
+std::size_t PointerStroke::pointerId() const
+{
+    return _pointerId;
+}
+
+
+uint64_t PointerStroke::minSequenceIndex() const
+{
+    return _minSequenceIndex;
+}
+
+
+uint64_t PointerStroke::maxSequenceIndex() const
+{
+    return _maxSequenceIndex;
+}
+
+
+uint64_t PointerStroke::minTimestampMicros() const
+{
+    if (_events.empty())
+        return 0;
+
+    return _events.front().timestampMicros();
+}
+
+
+uint64_t PointerStroke::maxTimestampMicros() const
+{
+    if (_events.empty())
+        return 0;
+
+    return _events.back().timestampMicros();
+}
+
+
+bool PointerStroke::isFinished() const
+{
+    return !_events.empty() && (_events.back().pointerEventType() == PointerEventType::POINTER_CANCEL
+                             || _events.back().pointerEventType() == PointerEventType::POINTER_UP);
+}
+
+
+bool PointerStroke::isCancelled() const
+{
+    return !_events.empty() && _events.back().pointerEventType() == PointerEventType::POINTER_CANCEL;
+}
+
+
+bool PointerStroke::isExpectingUpdates() const
+{
+    return _numExpectingUpdates > 0;
+}
+
+
+std::size_t PointerStroke::numPredictedEvents() const
+{
+    return _numPredictedEvents;
+}
+
+
+std::size_t PointerStroke::size() const
+{
+    return _events.size();
+}
+
+
+bool PointerStroke::empty() const
+{
+    return _events.empty();
+}
+
+
+const std::vector<PointerEventArgs>& PointerStroke::events() const
+{
+    return _events;
+}
+
+
+const PointerStrokeData& PointerStroke::data() const
+{
+    return _data;
+}
+
+
+std::size_t PointerStroke::modifiedIndex() const
+{
+    return _modifiedIndex;
+}
+
+
+std::size_t PointerStroke::numModifiedEvents() const
+{
+    return _numModifiedEvents;
+}
+
+
+ofRectangle PointerStroke::boundingBox() const
+{
+    if (_numMeasuredEvents() == 0)
+        return ofRectangle();
+
+    _validateExtrema();
+    return ofRectangle(_minPosition, _maxPosition);
+}
+
+
+double PointerStroke::arcLength() const
+{
+    return _arcLength;
+}
+
+
+uint64_t PointerStroke::durationMicros() const
+{
+    std::size_t numMeasured = _numMeasuredEvents();
+
+    if (numMeasured == 0)
+        return 0;
+
+    _validateExtrema();
+    return _maxTimestampMicros - _minTimestampMicros;
+}
+
+
+double PointerStroke::averageSpeed() const
+{
+    uint64_t duration = durationMicros();
+
+    if (duration == 0)
+        return 0;
+
+    return _arcLength * 1000000.0 / duration;
+}
+
+
+float PointerStroke::minPressure() const
+{
+    if (_numMeasuredEvents() == 0)
+        return 0;
+
+    _validateExtrema();
+    return _minPressure;
+}
+
+
+float PointerStroke::maxPressure() const
+{
+    if (_numMeasuredEvents() == 0)
+        return 0;
+
+    _validateExtrema();
+    return _maxPressure;
+}
+
+
+PointerDebugRenderer::Settings::Settings():
+    pointColor(ofColor::blue),
+    coalescedPointColor(ofColor::red),
+    predictedPointColor(ofColor::darkGray),
+    clock(PointerClock::defaultClock())
+{
+}
+
+
+PointerDebugRenderer::PointerDebugRenderer()
+{
+}
+
+
+PointerDebugRenderer::PointerDebugRenderer(const Settings& settings):
+    _settings(settings)
+{
+}
+
+
+PointerDebugRenderer::~PointerDebugRenderer()
+{
+}
+
+
+void PointerDebugRenderer::setup(const Settings& settings)
+{
+    _settings = settings;
+
+    auto meshesIter = _meshes.begin();
+
+    for (const auto& strokes: _strokes)
+    {
+        for (std::size_t i = 0; i < strokes.second.size(); ++i)
+            meshesIter->second[i].tessellate(strokes.second[i], _settings);
+
+        ++meshesIter;
+    }
+
+    _batchInvalid = true;
+
+    _fade();
+}
+
+
+void PointerDebugRenderer::update()
+{
+    auto now = _nowMillis();
+
+    // Avoid rollover by subtracting from an unsigned now.
+    if (now < _settings.timeoutMillis)
+        return;
+
+    auto lastValidTime = now - _settings.timeoutMillis;
+
+    // Only pointers with a stroke that may have expired are visited.
+    while (!_expiryQueue.empty() && _expiryQueue.top().timestampMillis < lastValidTime)
+    {
+        std::size_t pointerId = _expiryQueue.top().pointerId;
+        _expiryQueue.pop();
+
+        auto strokesIter = _strokes.find(pointerId);
+
+        if (strokesIter == _strokes.end())
+            continue;
+
+        auto meshesIter = _meshes.find(pointerId);
+
+        auto& strokes = strokesIter->second;
+        auto& meshes = meshesIter->second;
+
+        // A pointer's strokes are in time order, so they expire in order.
+        std::size_t numExpired = 0;
+
+        while (numExpired < strokes.size() && lastValidTime > _lastTimestampMillis(strokes[numExpired]))
+            ++numExpired;
+
+        if (numExpired > 0)
+        {
+            strokes.erase(strokes.begin(), strokes.begin() + numExpired);
+            meshes.erase(meshes.begin(), meshes.begin() + numExpired);
+            _batchInvalid = true;
+        }
+
+        if (strokes.empty())
+        {
+            _strokes.erase(strokesIter);
+            _meshes.erase(meshesIter);
+        }
+        else
+        {
+            // The first stroke may have had events added since it was queued.
+            _expiryQueue.push({ _lastTimestampMillis(strokes.front()), pointerId });
+        }
+    }
+
+    _fade();
+}
+
+
+void PointerDebugRenderer::draw() const
+{
+    _updateBatch();
+
+    _numVertices = _batch.getNumVertices();
+    _numBatches = 0;
+
+    if (_numVertices > 0)
+    {
+        _batch.draw();
+        ++_numBatches;
+    }
+}
+
+
+void PointerDebugRenderer::draw(const PointerStroke& stroke) const
+{
+    auto nowMillis = _nowMillis();
+
+    auto lastValidTimeMillis = nowMillis - _settings.timeoutMillis;
+
+    if (nowMillis < _settings.timeoutMillis)
+        lastValidTimeMillis = 0;
+
+    auto fadeTimeMillis = std::min(uint64_t(50), _settings.timeoutMillis);
+
+    StrokeMesh mesh;
+    mesh.fade(lastValidTimeMillis * 1000, fadeTimeMillis * 1000);
+    mesh.tessellate(stroke, _settings);
+    mesh.mesh().draw();
+}
+
+
+PointerDebugRenderer::Settings PointerDebugRenderer::settings() const
+{
+    return _settings;
+}
+
+
+void PointerDebugRenderer::clear()
+{
+    _strokes.clear();
+    _meshes.clear();
+    _expiryQueue = decltype(_expiryQueue)();
+    _batchInvalid = true;
+}
+
+
+void PointerDebugRenderer::add(const PointerEventArgs& e)
+{
+    // Ignore mouse just rolling around.
+    if (e.pointerDeviceType() == PointerDeviceType::MOUSE
+    && e.pointerEventType() == PointerEventType::POINTER_MOVE
+    && e.buttons() == 0)
+        return;
+
+    auto strokesIter = _strokes.find(e.pointerId());
+
+    if (e.pointerEventType() == PointerEventType::POINTER_UPDATE)
+    {
+        bool foundIt = false;
+        if (strokesIter != _strokes.end())
+        {
+            auto& strokes = strokesIter->second;
+
+            for (std::size_t i = 0; i < strokes.size(); ++i)
+            {
+                foundIt = strokes[i].add(e);
+                if (foundIt)
+                {
+                    // Only the updated event and its neighbours are tessellated.
+                    _meshes[e.pointerId()][i].tessellate(strokes[i],
+                                                         _settings,
+                                                         strokes[i].modifiedIndex(),
+                                                         strokes[i].modifiedIndex() + strokes[i].numModifiedEvents());
+                    _batchInvalid = true;
+                    break;
+                }
+            }
+        }
+
+        if (!foundIt)
+            ofLogError("PointerDebugRenderer::add") << "The sequence to be updated was nowhere to be found. This probably should not happen.";
+
+        return;
+    }
+
+    // Process all events.
+    if (strokesIter == _strokes.end())
+    {
+        bool result;
+        std::tie(strokesIter, result) = _strokes.insert(std::make_pair(e.pointerId(), std::vector<PointerStroke>()));
+    }
+
+    auto& meshes = _meshes[e.pointerId()];
+
+    // Each pointer with strokes has one entry in the expiry queue.
+    bool isQueued = !strokesIter->second.empty();
+
+    if (strokesIter->second.empty() || strokesIter->second.back().isFinished())
+    {
+        strokesIter->second.push_back(PointerStroke());
+        meshes.push_back(StrokeMesh());
+    }
+
+    // Get a reference to the current stroke.
+    auto& stroke = strokesIter->second.back();
+
+    bool result = stroke.add(e);
+
+    if (!isQueued)
+        _expiryQueue.push({ _lastTimestampMillis(stroke), e.pointerId() });
+
+    if (!result)
+    {
+        ofLogError("PointerDebugRenderer::add") << "Could not add event.";
+        return;
+    }
+
+    meshes.back().tessellate(stroke,
+                             _settings,
+                             stroke.modifiedIndex(),
+                             stroke.modifiedIndex() + stroke.numModifiedEvents());
+
+    _batchInvalid = true;
+}
+
+
+const std::map<std::size_t, std::vector<PointerStroke>>& PointerDebugRenderer::strokes() const
+{
+    return _strokes;
+}
+
+
+std::size_t PointerDebugRenderer::numVertices() const
+{
+    return _numVertices;
+}
+
+
+std::size_t PointerDebugRenderer::numBatches() const
+{
+    return _numBatches;
+}
+
+
+uint64_t PointerDebugRenderer::_nowMillis() const
+{
+    if (_settings.clock)
+        return _settings.clock->nowMicros() / 1000;
+
+    return PointerClock::defaultClock()->nowMicros() / 1000;
+}
+
+
+void PointerDebugRenderer::_fade()
+{
+    auto nowMillis = _nowMillis();
+
+    auto lastValidTimeMillis = nowMillis - _settings.timeoutMillis;
+
+    if (nowMillis < _settings.timeoutMillis)
+        lastValidTimeMillis = 0;
+
+    auto fadeTimeMillis = std::min(uint64_t(50), _settings.timeoutMillis);
+
+    // Strokes that were faded may become opaque again if time goes backwards.
+    bool fadeAll = lastValidTimeMillis < _lastValidTimeMillis || fadeTimeMillis != _fadeTimeMillis;
+
+    _lastValidTimeMillis = lastValidTimeMillis;
+    _fadeTimeMillis = fadeTimeMillis;
+
+    auto meshesIter = _meshes.begin();
+
+    for (const auto& strokes: _strokes)
+    {
+        auto& meshes = meshesIter->second;
+
+        // Strokes are in time order, so only the first strokes can be fading.
+        for (std::size_t i = 0; i < strokes.second.size(); ++i)
+        {
+            if (!fadeAll && strokes.second[i].minTimestampMicros() > (lastValidTimeMillis + fadeTimeMillis) * 1000)
+                break;
+
+            if (meshes[i].fade(lastValidTimeMillis * 1000, fadeTimeMillis * 1000))
+                _batchInvalid = true;
+        }
+
+        ++meshesIter;
+    }
+}
+
+
+uint64_t PointerDebugRenderer::_lastTimestampMillis(const PointerStroke& stroke)
+{
+    if (stroke.empty())
+        return 0;
+
+    return stroke.events().back().timestampMillis();
+}
+
+
+void PointerDebugRenderer::_updateBatch() const
+{
+    if (!_batchInvalid)
+        return;
+
+    _batch.setMode(OF_PRIMITIVE_TRIANGLE_STRIP);
+    _batch.setUsage(GL_DYNAMIC_DRAW);
+
+    auto& vertices = _batch.getVertices();
+    auto& colors = _batch.getColors();
+
+    vertices.clear();
+    colors.clear();
+
+    for (const auto& meshes: _meshes)
+    {
+        for (const auto& mesh: meshes.second)
+        {
+            const auto& meshVertices = mesh.mesh().getVertices();
+            const auto& meshColors = mesh.mesh().getColors();
+
+            if (meshVertices.empty())
+                continue;
+
+            // Join the strips with two degenerate triangles. Each strip has
+            // an even number of vertices, so the winding is preserved.
+            if (!vertices.empty())
+            {
+                vertices.push_back(vertices.back());
+                vertices.push_back(meshVertices.front());
+                colors.push_back(colors.back());
+                colors.push_back(meshColors.front());
+            }
+
+            vertices.insert(vertices.end(), meshVertices.begin(), meshVertices.end());
+            colors.insert(colors.end(), meshColors.begin(), meshColors.end());
+        }
+    }
+
+    _batchInvalid = false;
+}
+
+
+void PointerDebugRenderer::StrokeMesh::tessellate(const PointerStroke& stroke,
+                                                  const Settings& settings,
+                                                  std::size_t first,
+                                                  std::size_t last)
+{
+    const auto& events = stroke.events();
+
+    std::size_t oldSize = _samples.size();
+    std::size_t size = events.size();
+
+    // A stroke that grew or shrank changes the neighbours of its last event.
+    if (size != oldSize)
+    {
+        first = std::min(first, std::min(oldSize, size));
+        last = size;
+    }
+
+    last = std::min(last, size);
+
+    _numTessellatedEvents = 0;
+
+    if (first >= last && size == oldSize)
+        return;
+
+    // Tangents depend on the neighbouring events.
+    std::size_t begin = first > 0 ? first - 1 : 0;
+    std::size_t end = std::min(last + 1, size);
+
+    _mesh.setMode(OF_PRIMITIVE_TRIANGLE_STRIP);
+    _mesh.getVertices().resize(size * 2);
+    _mesh.getColors().resize(size * 2);
+    _samples.resize(size);
+    _numFadedEvents = std::min(_numFadedEvents, size);
+
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        _tessellate(events, settings, i);
+        _color(i);
+        ++_numTessellatedEvents;
+    }
+}
+
+
+void PointerDebugRenderer::StrokeMesh::tessellate(const PointerStroke& stroke,
+                                                  const Settings& settings)
+{
+    tessellate(stroke, settings, 0, stroke.size());
+}
+
+
+bool PointerDebugRenderer::StrokeMesh::fade(uint64_t lastValidTimeMicros,
+                                            uint64_t fadeTimeMicros)
+{
+    auto compare = [](uint64_t timestampMicros, const Sample& sample)
+    {
+        return timestampMicros < sample.timestampMicros;
+    };
+
+    std::size_t begin = _numFadedEvents;
+    std::size_t end = _samples.size();
+
+    // Opacity only decreases as time moves forward, so events that are
+    // transparent stay transparent and events newer than the fade are opaque.
+    if (lastValidTimeMicros >= _lastValidTimeMicros && fadeTimeMicros == _fadeTimeMicros)
+    {
+        end = std::upper_bound(_samples.begin() + begin,
+                               _samples.end(),
+                               lastValidTimeMicros + fadeTimeMicros,
+                               compare) - _samples.begin();
+    }
+    else
+    {
+        begin = 0;
+    }
+
+    _lastValidTimeMicros = lastValidTimeMicros;
+    _fadeTimeMicros = fadeTimeMicros;
+
+    for (std::size_t i = begin; i < end; ++i)
+        _color(i);
+
+    _numFadedEvents = std::upper_bound(_samples.begin() + begin,
+                                       _samples.begin() + end,
+                                       lastValidTimeMicros,
+                                       compare) - _samples.begin();
+
+    return begin < end;
+}
+
+
+const ofMesh& PointerDebugRenderer::StrokeMesh::mesh() const
+{
+    return _mesh;
+}
+
+
+std::size_t PointerDebugRenderer::StrokeMesh::numTessellatedEvents() const
+{
+    return _numTessellatedEvents;
+}
+
+
+void PointerDebugRenderer::StrokeMesh::_tessellate(const std::vector<PointerEventArgs>& events,
+                                                   const Settings& settings,
+                                                   std::size_t i)
+{
+    bool useZ = false;
+    float R = settings.strokeWidth;
+
+    const auto& e = events[i];
+
+    // Pen tip.
+    glm::vec3 p0 = { e.position().x, e.position().y, 0 };
+    glm::vec3 p1 = p0;
+
+    float az = e.point().azimuthRad();
+    float al = e.point().altitudeRad();
+
+    if (!ofIsFloatEqual(az, 0.0f) || !ofIsFloatEqual(al, 0.0f))
+    {
+        float cosAl = std::cos(al);
+        p1.x += R * std::cos(az) * cosAl;
+        p1.y += R * std::sin(az) * cosAl;
+
+        if (useZ)
+            p1.z += R * std::sin(al);
+    }
+    else
+    {
+        // If no altitude / azimuth are available, use tangents to simulate.
+        if (i > 0 && i < events.size() - 1)
+        {
+            std::size_t i1 = i - 1;
+            std::size_t i2 = i;
+            std::size_t i3 = i + 1;
+            const auto& p_1 = events[i1].position();
+            const auto& p_2 = events[i2].position();
+            const auto& p_3 = events[i3].position();
+            auto v1(p_1 - p_2); // vector to previous point
+            auto v2(p_3 - p_2); // vector to next point
+            v1 = glm::normalize(v1);
+            v2 = glm::normalize(v2);
+            glm::vec2 tangent = glm::length2(v2 - v1) > 0 ? glm::normalize(v2 - v1) : -v1;
+            glm::vec3 normal = glm::cross(glm::vec3(tangent, 0), { 0, 0, 1 });
+            auto pp0 = p_2 + normal * R / 2;
+            auto pp1 = p_2 - normal * R / 2;
+            p0 = { pp0.x, pp0.y, 0 };
+            p1 = { pp1.x, pp1.y, 0 };
+        }
+    }
+
+    auto& vertices = _mesh.getVertices();
+    vertices[i * 2] = p0;
+    vertices[i * 2 + 1] = p1;
+
+    Sample& sample = _samples[i];
+
+    // Here we color the points based on the point type.
+    if (e.isCoalesced())
+        sample.color = settings.coalescedPointColor;
+    else if (e.isPredicted())
+        sample.color = settings.predictedPointColor;
+    else
+        sample.color = settings.pointColor;
+
+    sample.pressure = e.point().pressure();
+    sample.isFaded = !e.isPredicted();
+    sample.timestampMicros = e.timestampMicros();
+}
+
+
+void PointerDebugRenderer::StrokeMesh::_color(std::size_t i)
+{
+    const Sample& sample = _samples[i];
+
+    ofColor c = sample.color;
+
+    // Here we combine the age of the line and the pressure to fade out
+    // the line via an opacity change.
+    if (sample.isFaded)
+    {
+        double timeRemainingMicros = double(sample.timestampMicros) - double(_lastValidTimeMicros);
+        float fader = timeRemainingMicros > 0 ? 1 : 0;
+
+        if (_fadeTimeMicros > 0)
+            fader = ofMap(timeRemainingMicros, _fadeTimeMicros, 0, 1, 0, true);
+
+        c = ofColor(sample.color, sample.pressure * fader * 255);
+    }
+
+    auto& colors = _mesh.getColors();
+    colors[i * 2] = c;
+    colors[i * 2 + 1] = c;
+}
+
+
+PointerEventCollection::PointerEventCollection()
+{
+}
+
+
+PointerEventCollection::PointerEventCollection(const PointerEventCollection& other)
+{
+    *this = other;
+}
+
+
+PointerEventCollection::~PointerEventCollection()
+{
+}
+
+
+PointerEventCollection& PointerEventCollection::operator = (const PointerEventCollection& other)
+{
+    if (this != &other)
+    {
+        clear();
+
+        _retentionMicros = other._retentionMicros;
+
+        for (std::size_t index = other._first; index != NPOS; index = other._node(index).next)
+            add(other._node(index).event);
+    }
+
+    return *this;
+}
+
+
+std::size_t PointerEventCollection::size() const
+{
+    return _size;
+}
+
+
+bool PointerEventCollection::empty() const
+{
+    return _size == 0;
+}
+
+
+void PointerEventCollection::clear()
+{
+    _chunks.clear();
+    _numNodes = 0;
+    _free = NPOS;
+    _first = NPOS;
+    _last = NPOS;
+    _size = 0;
+    _pointers.clear();
+    _timeIndex.clear();
+    _numStaleIndexEntries = 0;
+    _maxTimestampMicros = 0;
+}
+
+
+std::size_t PointerEventCollection::numPointers() const
+{
+    return _pointers.size();
+}
+
+
+bool PointerEventCollection::hasPointerId(std::size_t pointerId)
+{
+    return _pointers.find(pointerId) != _pointers.end();
+}
+
+
+void PointerEventCollection::add(const PointerEventArgs& pointerEvent)
+{
+    std::size_t index = _allocate(pointerEvent);
+    Node& node = _node(index);
+
+    // Append to the list of all events.
+    node.previous = _last;
+    node.next = NPOS;
+
+    if (_last != NPOS)
+        _node(_last).next = index;
+    else
+        _first = index;
+
+    _last = index;
+
+    // Append to the list of the pointer's events.
+    PointerList& list = _pointers[pointerEvent.pointerId()];
+
+    node.pointerPrevious = list.last;
+    node.pointerNext = NPOS;
+
+    if (list.last != NPOS)
+        _node(list.last).pointerNext = index;
+    else
+        list.first = index;
+
+    list.last = index;
+    ++list.size;
+
+    ++_size;
+
+    // Index the event, keeping the index sorted.
+    _maxTimestampMicros = std::max(_maxTimestampMicros, pointerEvent.timestampMicros());
+    node.indexTimestampMicros = _maxTimestampMicros;
+
+    IndexEntry entry;
+    entry.timestampMicros = node.indexTimestampMicros;
+    entry.index = index;
+    entry.generation = node.generation;
+
+    _timeIndex.push_back(entry);
+    list.timeIndex.push_back(entry);
+
+    if (_retentionMicros > 0 && _maxTimestampMicros > _retentionMicros)
+        removeEventsBefore(_maxTimestampMicros - _retentionMicros);
+}
+
+
+void PointerEventCollection::removeEventsForPointerId(std::size_t pointerId)
+{
+    auto iter = _pointers.find(pointerId);
+
+    if (iter == _pointers.end())
+        return;
+
+    std::size_t index = iter->second.first;
+
+    while (index != NPOS)
+    {
+        Node& node = _node(index);
+        std::size_t pointerNext = node.pointerNext;
+
+        // Unlink from the list of all events.
+        if (node.previous != NPOS)
+            _node(node.previous).next = node.next;
+        else
+            _first = node.next;
+
+        if (node.next != NPOS)
+            _node(node.next).previous = node.previous;
+        else
+            _last = node.previous;
+
+        _release(index);
+        --_size;
+
+        index = pointerNext;
+    }
+
+    // The time index entries are removed lazily.
+    _numStaleIndexEntries += iter->second.size;
+
+    _pointers.erase(iter);
+
+    if (_numStaleIndexEntries > _timeIndex.size() / 2)
+        _compactTimeIndex();
+}
+
+
+void PointerEventCollection::removeEventsBefore(uint64_t timestampMicros)
+{
+    while (_first != NPOS && _node(_first).indexTimestampMicros < timestampMicros)
+        _removeFirst();
+}
+
+
+void PointerEventCollection::setRetentionMicros(uint64_t retentionMicros)
+{
+    _retentionMicros = retentionMicros;
+
+    if (_retentionMicros > 0 && _maxTimestampMicros > _retentionMicros)
+        removeEventsBefore(_maxTimestampMicros - _retentionMicros);
+}
+
+
+uint64_t PointerEventCollection::getRetentionMicros() const
+{
+    return _retentionMicros;
+}
+
+
+PointerEventCollection::EventRange PointerEventCollection::eventRange() const
+{
+    return EventRange(const_iterator(this, _first, false),
+                      const_iterator(this, NPOS, false));
+}
+
+
+PointerEventCollection::EventRange PointerEventCollection::eventRange(uint64_t minTimestampMicros,
+                                                                      uint64_t maxTimestampMicros) const
+{
+    auto lower = std::lower_bound(_timeIndex.begin(),
+                                  _timeIndex.end(),
+                                  minTimestampMicros,
+                                  [](const IndexEntry& entry, uint64_t timestampMicros) {
+                                      return entry.timestampMicros < timestampMicros;
+                                  });
+
+    auto upper = std::upper_bound(lower,
+                                  _timeIndex.end(),
+                                  maxTimestampMicros,
+                                  [](uint64_t timestampMicros, const IndexEntry& entry) {
+                                      return timestampMicros < entry.timestampMicros;
+                                  });
+
+    std::size_t first = _liveIndexAt(lower - _timeIndex.begin());
+    std::size_t last = _liveIndexAt(upper - _timeIndex.begin());
+
+    return EventRange(const_iterator(this, first, false),
+                      const_iterator(this, last, false));
+}
+
+
+PointerEventCollection::EventRange PointerEventCollection::eventRangeForPointerId(std::size_t pointerId) const
+{
+    auto iter = _pointers.find(pointerId);
+
+    if (iter == _pointers.end())
+        return EventRange();
+
+    return EventRange(const_iterator(this, iter->second.first, true),
+                      const_iterator(this, NPOS, true));
+}
+
+
+PointerEventCollection::EventRange PointerEventCollection::eventRangeForPointerId(std::size_t pointerId,
+                                                                                  uint64_t minTimestampMicros,
+                                                                                  uint64_t maxTimestampMicros) const
+{
+    auto iter = _pointers.find(pointerId);
+
+    if (iter == _pointers.end())
+        return EventRange();
+
+    const auto& timeIndex = iter->second.timeIndex;
+
+    auto lower = std::lower_bound(timeIndex.begin(),
+                                  timeIndex.end(),
+                                  minTimestampMicros,
+                                  [](const IndexEntry& entry, uint64_t timestampMicros) {
+                                      return entry.timestampMicros < timestampMicros;
+                                  });
+
+    auto upper = std::upper_bound(lower,
+                                  timeIndex.end(),
+                                  maxTimestampMicros,
+                                  [](uint64_t timestampMicros, const IndexEntry& entry) {
+                                      return timestampMicros < entry.timestampMicros;
+                                  });
+
+    // A pointer's index has no entries for removed events.
+    std::size_t first = lower != timeIndex.end() ? lower->index : NPOS;
+    std::size_t last = upper != timeIndex.end() ? upper->index : NPOS;
+
+    return EventRange(const_iterator(this, first, true),
+                      const_iterator(this, last, true));
+}
+
+
+std::vector<PointerEventArgs> PointerEventCollection::events() const
+{
+    auto range = eventRange();
+    return std::vector<PointerEventArgs>(range.begin(), range.end());
+}
+
+
+std::vector<PointerEventArgs> PointerEventCollection::events(uint64_t minTimestampMicros,
+                                                             uint64_t maxTimestampMicros) const
+{
+    auto range = eventRange(minTimestampMicros, maxTimestampMicros);
+    return std::vector<PointerEventArgs>(range.begin(), range.end());
+}
+
+
+std::vector<PointerEventArgs> PointerEventCollection::eventsForPointerId(std::size_t pointerId) const
+{
+    auto range = eventRangeForPointerId(pointerId);
+    return std::vector<PointerEventArgs>(range.begin(), range.end());
 }
 
 
-PointerEvents* PointerEventsManager::events()
+std::vector<PointerEventArgs> PointerEventCollection::eventsForPointerId(std::size_t pointerId,
+                                                                         uint64_t minTimestampMicros,
+                                                                         uint64_t maxTimestampMicros) const
 {
-    return eventsForWindow(nullptr);
+    auto range = eventRangeForPointerId(pointerId, minTimestampMicros, maxTimestampMicros);
+    return std::vector<PointerEventArgs>(range.begin(), range.end());
 }
 
 
-PointerEvents* PointerEventsManager::eventsForWindow(ofAppBaseWindow* window)
+const PointerEventArgs* PointerEventCollection::firstEventForPointerId(std::size_t pointerId) const
 {
-    auto iter = _windowEventMap.find(window);
+    auto iter = _pointers.find(pointerId);
 
-    if (iter != _windowEventMap.end())
+    if (iter != _pointers.end())
     {
-        return iter->second.get();
+        return &_node(iter->second.first).event;
     }
 
-    _windowEventMap[window] = std::make_unique<PointerEvents>(window);
-    return _windowEventMap[window].get();
+    return nullptr;
 }
 
 
-PointerEventsManager& PointerEventsManager::instance()
+const PointerEventArgs* PointerEventCollection::lastEventForPointerId(std::size_t pointerId) const
 {
-    static PointerEventsManager instance;
-    return instance;
+    auto iter = _pointers.find(pointerId);
+
+    if (iter != _pointers.end())
+    {
+        return &_node(iter->second.last).event;
+    }
+
+    return nullptr;
 }
 
 
-PointerEventsManager::PointerEventsManager()
+PointerEventCollection::const_iterator::const_iterator()
 {
 }
 
 
-PointerEventsManager::~PointerEventsManager()
+PointerEventCollection::const_iterator::const_iterator(const PointerEventCollection* collection,
+                                                       std::size_t index,
+                                                       bool pointerOnly):
+    _collection(collection),
+    _index(index),
+    _pointerOnly(pointerOnly)
 {
 }
 
 
+PointerEventCollection::const_iterator::reference PointerEventCollection::const_iterator::operator * () const
+{
+    return _collection->_node(_index).event;
+}
+
 
-PointerStroke::PointerStroke()
+PointerEventCollection::const_iterator::pointer PointerEventCollection::const_iterator::operator -> () const
 {
+    return &_collection->_node(_index).event;
 }
 
 
-PointerStroke::~PointerStroke()
+PointerEventCollection::const_iterator& PointerEventCollection::const_iterator::operator ++ ()
 {
+    const Node& node = _collection->_node(_index);
+    _index = _pointerOnly ? node.pointerNext : node.next;
+    return *this;
 }
 
 
-bool PointerStroke::add(const PointerEventArgs& e)
+PointerEventCollection::const_iterator PointerEventCollection::const_iterator::operator ++ (int)
 {
-    if (_events.empty())
-        _pointerId = e.pointerId();
+    const_iterator result = *this;
+    ++(*this);
+    return result;
+}
 
-    if (_pointerId != e.pointerId())
-        return false;
 
-    if (e.eventType() == PointerEventArgs::POINTER_UPDATE)
-    {
-        auto riter = _events.rbegin();
-        while (riter != _events.rend())
-        {
-            if (riter->sequenceIndex() == e.sequenceIndex())
-            {
-                if (!riter->updateEstimatedPropertiesWithEvent(e))
-                    ofLogError("PointerStroke::add") << "Error updating matching property.";
-                return true;
-            }
-            ++riter;
-        }
+bool PointerEventCollection::const_iterator::operator == (const const_iterator& other) const
+{
+    return _index == other._index;
+}
 
-        return false;
-    }
 
-    // Remove predicted events.
-    _events.erase(std::remove_if(_events.begin(),
-                                 _events.end(),
-                                [](const PointerEventArgs& x) { return x.isPredicted(); }),
-                 _events.end());
+bool PointerEventCollection::const_iterator::operator != (const const_iterator& other) const
+{
+    return _index != other._index;
+}
 
-    // Add coalesced events, this includes the current event.
-    auto coalesced = e.coalescedPointerEvents();
-    _events.insert(_events.end(), coalesced.begin(), coalesced.end());
 
-    if (coalesced.empty())
-        ofLogError("PointerStroke::add") << "No coalesced events!";
+PointerEventCollection::EventRange::EventRange()
+{
+}
 
-    // Add predicted events.
-    auto predicted = e.predictedPointerEvents();
-    _events.insert(_events.end(), predicted.begin(), predicted.end());
 
-    _minSequenceIndex = std::min(e.sequenceIndex(), _minSequenceIndex);
-    _maxSequenceIndex = std::max(e.sequenceIndex(), _maxSequenceIndex);
+PointerEventCollection::EventRange::EventRange(const_iterator begin, const_iterator end):
+    _begin(begin),
+    _end(end)
+{
+}
 
-    return true;
+
+PointerEventCollection::const_iterator PointerEventCollection::EventRange::begin() const
+{
+    return _begin;
 }
 
 
-std::size_t PointerStroke::pointerId() const
+PointerEventCollection::const_iterator PointerEventCollection::EventRange::end() const
 {
-    return _pointerId;
+    return _end;
 }
 
 
-uint64_t PointerStroke::minSequenceIndex() const
+bool PointerEventCollection::EventRange::empty() const
 {
-    return _minSequenceIndex;
+    return _begin == _end;
 }
 
 
-uint64_t PointerStroke::maxSequenceIndex() const
+std::size_t PointerEventCollection::EventRange::size() const
 {
-    return _maxSequenceIndex;
+    return std::distance(_begin, _end);
 }
 
 
-uint64_t PointerStroke::minTimestampMicros() const
+PointerEventCollection::Node& PointerEventCollection::_node(std::size_t index)
 {
-    if (_events.empty())
-        return 0;
+    return _chunks[index / CHUNK_SIZE][index % CHUNK_SIZE];
+}
 
-    return _events.front().timestampMicros();
+
+const PointerEventCollection::Node& PointerEventCollection::_node(std::size_t index) const
+{
+    return _chunks[index / CHUNK_SIZE][index % CHUNK_SIZE];
 }
 
 
-uint64_t PointerStroke::maxTimestampMicros() const
+std::size_t PointerEventCollection::_allocate(const PointerEventArgs& pointerEvent)
 {
-    if (_events.empty())
-        return 0;
+    std::size_t index = _free;
 
-    return _events.back().timestampMicros();
+    if (index != NPOS)
+    {
+        _free = _node(index).next;
+    }
+    else
+    {
+        if (_numNodes == _chunks.size() * CHUNK_SIZE)
+            _chunks.push_back(std::unique_ptr<Node[]>(new Node[CHUNK_SIZE]));
+
+        index = _numNodes++;
+    }
+
+    _node(index).event = pointerEvent;
+    return index;
 }
 
 
-bool PointerStroke::isFinished() const
+void PointerEventCollection::_release(std::size_t index)
 {
-    return !_events.empty() && (_events.back().eventType() == PointerEventArgs::POINTER_CANCEL
-                             || _events.back().eventType() == PointerEventArgs::POINTER_UP);
+    Node& node = _node(index);
+
+    // Release any memory held by the event.
+    node.event = PointerEventArgs();
+    node.previous = NPOS;
+    node.pointerPrevious = NPOS;
+    node.pointerNext = NPOS;
+    node.next = _free;
+    ++node.generation;
+
+    _free = index;
 }
 
 
-bool PointerStroke::isCancelled() const
+void PointerEventCollection::_removeFirst()
 {
-    return !_events.empty() && _events.back().eventType() == PointerEventArgs::POINTER_CANCEL;
+    std::size_t index = _first;
+    Node& node = _node(index);
+
+    // Unlink from the list of all events.
+    _first = node.next;
+
+    if (_first != NPOS)
+        _node(_first).previous = NPOS;
+    else
+        _last = NPOS;
+
+    // The oldest event is also the first of its pointer's events.
+    auto iter = _pointers.find(node.event.pointerId());
+    PointerList& list = iter->second;
+
+    list.first = node.pointerNext;
+    list.timeIndex.pop_front();
+    --list.size;
+
+    if (list.first != NPOS)
+        _node(list.first).pointerPrevious = NPOS;
+    else
+        _pointers.erase(iter);
+
+    // Remove the entry and any preceding entries for removed events.
+    while (!_timeIndex.empty())
+    {
+        bool isNode = _timeIndex.front().index == index
+                   && _timeIndex.front().generation == node.generation;
+
+        if (!isNode)
+            --_numStaleIndexEntries;
+
+        _timeIndex.pop_front();
+
+        if (isNode)
+            break;
+    }
+
+    _release(index);
+    --_size;
 }
 
 
-bool PointerStroke::isExpectingUpdates() const
+std::size_t PointerEventCollection::_liveIndexAt(std::size_t position) const
 {
-    // Start at the end, because newer events are likely the ones with estimated
-    // properties.
-    auto riter = _events.rbegin();
-    while (riter != _events.rend())
+    while (position < _timeIndex.size())
     {
-        if (!riter->estimatedProperties().empty())
-            return true;
+        const IndexEntry& entry = _timeIndex[position];
+
+        if (_node(entry.index).generation == entry.generation)
+            return entry.index;
 
-        ++riter;
+        ++position;
     }
 
-    return false;
+    return NPOS;
 }
 
 
-std::size_t PointerStroke::size() const
+void PointerEventCollection::_compactTimeIndex()
 {
-    return _events.size();
+    _timeIndex.clear();
+
+    for (std::size_t index = _first; index != NPOS; index = _node(index).next)
+    {
+        IndexEntry entry;
+        entry.timestampMicros = _node(index).indexTimestampMicros;
+        entry.index = index;
+        entry.generation = _node(index).generation;
+        _timeIndex.push_back(entry);
+    }
+
+    _numStaleIndexEntries = 0;
 }
 
 
-bool PointerStroke::empty() const
+PointerHistoryRing::const_iterator::const_iterator()
 {
-    return _events.empty();
 }
 
 
-const std::vector<PointerEventArgs>& PointerStroke::events() const
+PointerHistoryRing::const_iterator::const_iterator(const PointerHistoryRing* ring,
+                                                   std::size_t index,
+                                                   bool pointerOnly):
+    _ring(ring),
+    _index(index),
+    _pointerOnly(pointerOnly)
 {
-    return _events;
 }
 
 
-PointerDebugRenderer::Settings::Settings():
-    pointColor(ofColor::blue),
-    coalescedPointColor(ofColor::red),
-    predictedPointColor(ofColor::darkGray)
+PointerHistoryRing::const_iterator::reference PointerHistoryRing::const_iterator::operator * () const
 {
+    return _ring->_slots[_index].event;
 }
 
 
-PointerDebugRenderer::PointerDebugRenderer()
+PointerHistoryRing::const_iterator::pointer PointerHistoryRing::const_iterator::operator -> () const
 {
+    return &_ring->_slots[_index].event;
 }
 
 
-PointerDebugRenderer::PointerDebugRenderer(const Settings& settings):
-    _settings(settings)
+PointerHistoryRing::const_iterator& PointerHistoryRing::const_iterator::operator ++ ()
 {
+    _index = _ring->_next(_index, _pointerOnly);
+    return *this;
 }
 
 
-PointerDebugRenderer::~PointerDebugRenderer()
+PointerHistoryRing::const_iterator PointerHistoryRing::const_iterator::operator ++ (int)
 {
+    const_iterator result = *this;
+    ++(*this);
+    return result;
 }
 
 
-void PointerDebugRenderer::setup(const Settings& settings)
+bool PointerHistoryRing::const_iterator::operator == (const const_iterator& other) const
 {
-    _settings = settings;
+    return _index == other._index;
 }
 
 
-void PointerDebugRenderer::update()
+bool PointerHistoryRing::const_iterator::operator != (const const_iterator& other) const
 {
-    if (!_strokes.empty())
-    {
-        auto now = ofGetElapsedTimeMillis();
+    return _index != other._index;
+}
+
 
-        // Avoid rollover by subtracting from an unsigned now.
-        if (now < _settings.timeoutMillis)
-            return;
+PointerHistoryRing::EventRange::EventRange()
+{
+}
 
-        auto lastValidTime = now - _settings.timeoutMillis;
 
-        auto iter = _strokes.begin();
+PointerHistoryRing::EventRange::EventRange(const_iterator begin):
+    _begin(begin)
+{
+}
 
-        while (iter != _strokes.end())
-        {
-            if (iter->second.empty())
-                iter = _strokes.erase(iter);
-            else
-            {
-                iter->second.erase(std::remove_if(iter->second.begin(),
-                                                  iter->second.end(),
-                                                  [&](const PointerStroke& x)
-                                                  { return lastValidTime > x.events().back().timestampMillis(); }),
-                                    iter->second.end());
-                ++iter;
-            }
-        }
-    }
+
+PointerHistoryRing::const_iterator PointerHistoryRing::EventRange::begin() const
+{
+    return _begin;
 }
 
 
-void PointerDebugRenderer::draw() const
+PointerHistoryRing::const_iterator PointerHistoryRing::EventRange::end() const
 {
-    for (auto& strokes: _strokes)
-        for (auto& stroke: strokes.second)
-            draw(stroke);
+    return const_iterator(_begin._ring, NPOS, _begin._pointerOnly);
 }
 
 
-void PointerDebugRenderer::draw(const PointerStroke& stroke) const
+bool PointerHistoryRing::EventRange::empty() const
 {
-    auto nowMillis = ofGetElapsedTimeMillis();
+    return _begin._index == NPOS;
+}
 
-    auto lastValidTimeMillis = nowMillis - _settings.timeoutMillis;
 
-    if (nowMillis < _settings.timeoutMillis)
-        lastValidTimeMillis = 0;
+PointerHistoryRing::PointerHistoryRing(std::size_t capacity,
+                                       std::size_t samplesPerEvent):
+    _slots(std::max(capacity, std::size_t(1))),
+    _samplesPerEvent(samplesPerEvent),
+    _pointers(_slots.size() * 2)
+{
+    for (auto& slot: _slots)
+        slot.event.reserveSamples(_samplesPerEvent);
+}
 
-    ofMesh mesh;
-    mesh.setMode(OF_PRIMITIVE_TRIANGLE_STRIP);
 
-    bool useZ = false;
-    float R = _settings.strokeWidth;
-    auto fadeTimeMillis = std::min(uint64_t(50), _settings.timeoutMillis);
+PointerHistoryRing::~PointerHistoryRing()
+{
+}
 
-    const auto& events = stroke.events();
 
-    for (std::size_t i = 0; i < events.size(); ++i)
-    {
-        const auto& e = events[i];
+std::size_t PointerHistoryRing::capacityForBytes(std::size_t bytes,
+                                                 std::size_t samplesPerEvent)
+{
+    std::size_t bytesPerEvent = sizeof(Slot) + 2 * sizeof(PointerEntry);
 
-        // Pen tip.
-        glm::vec3 p0 = { e.position().x, e.position().y, 0 };
-        glm::vec3 p1 = p0;
+    if (samplesPerEvent > PointerSampleBuffer::INLINE_CAPACITY)
+        bytesPerEvent += samplesPerEvent * sizeof(PointerSample);
 
-        float az = e.point().azimuthRad();
-        float al = e.point().altitudeRad();
+    return std::max(bytes / bytesPerEvent, std::size_t(1));
+}
 
-        if (!ofIsFloatEqual(az, 0.0f) || !ofIsFloatEqual(al, 0.0f))
-        {
-            float cosAl = std::cos(al);
-            p1.x += R * std::cos(az) * cosAl;
-            p1.y += R * std::sin(az) * cosAl;
 
-            if (useZ)
-                p1.z += R * std::sin(al);
-        }
-        else
-        {
-            // If no altitude / azimuth are available, use tangents to simulate.
-            if (i > 0 && i < events.size() - 1)
-            {
-                std::size_t i1 = i - 1;
-                std::size_t i2 = i;
-                std::size_t i3 = i + 1;
-                const auto& p_1 = events[i1].position();
-                const auto& p_2 = events[i2].position();
-                const auto& p_3 = events[i3].position();
-                auto v1(p_1 - p_2); // vector to previous point
-                auto v2(p_3 - p_2); // vector to next point
-                v1 = glm::normalize(v1);
-                v2 = glm::normalize(v2);
-                glm::vec2 tangent = glm::length2(v2 - v1) > 0 ? glm::normalize(v2 - v1) : -v1;
-                glm::vec3 normal = glm::cross(glm::vec3(tangent, 0), { 0, 0, 1 });
-                auto pp0 = p_2 + normal * R / 2;
-                auto pp1 = p_2 - normal * R / 2;
-                p0 = { pp0.x, pp0.y, 0 };
-                p1 = { pp1.x, pp1.y, 0 };
-            }
-        }
+std::size_t PointerHistoryRing::samplesPerEvent() const
+{
+    return _samplesPerEvent;
+}
 
-        // Here we combine the age of the line and the pressure to fade out
-        // the line via an opacity change.
-        float pressure = e.point().pressure();
 
-        double timeRemainingMillis = double(e.timestampMillis()) - double(lastValidTimeMillis);
-        float fader = ofMap(timeRemainingMillis, fadeTimeMillis, 0, 1, 0, true);
-        float pressureFader = pressure * fader;
+std::size_t PointerHistoryRing::size() const
+{
+    return _size;
+}
 
-        ofColor c0, c1;
 
-        // Here we color the points based on the point type.
-        if (e.isCoalesced())
-            c0 = c1 = ofColor(_settings.coalescedPointColor, pressureFader * 255);
-        else if (e.isPredicted())
-            c0 = c1 = ofColor(_settings.predictedPointColor);
-        else
-            c0 = c1 = ofColor(_settings.pointColor, pressureFader * 255);
+std::size_t PointerHistoryRing::capacity() const
+{
+    return _slots.size();
+}
 
-        mesh.addVertex(p0);
-        mesh.addColor(c0);
-        mesh.addVertex(p1);
-        mesh.addColor(c1);
-    }
 
-    mesh.draw();
+bool PointerHistoryRing::empty() const
+{
+    return _size == 0;
 }
 
 
-PointerDebugRenderer::Settings PointerDebugRenderer::settings() const
+bool PointerHistoryRing::full() const
 {
-    return _settings;
+    return _size == _slots.size();
 }
 
 
-void PointerDebugRenderer::clear()
+void PointerHistoryRing::clear()
 {
-    _strokes.clear();
+    _first = 0;
+    _size = 0;
+    std::fill(_pointers.begin(), _pointers.end(), PointerEntry());
+    _numPointers = 0;
 }
 
 
-void PointerDebugRenderer::add(const PointerEventArgs& e)
+std::size_t PointerHistoryRing::numPointers() const
 {
-    // Ignore mouse just rolling around.
-    if (e.deviceType() == PointerEventArgs::TYPE_MOUSE
-    && e.eventType() == PointerEventArgs::POINTER_MOVE
-    && e.buttons() == 0)
-        return;
+    return _numPointers;
+}
 
-    auto strokesIter = _strokes.find(e.pointerId());
 
-    if (e.eventType() == PointerEventArgs::POINTER_UPDATE)
-    {
-        bool foundIt = false;
-        if (strokesIter != _strokes.end())
-        {
-            for (auto& stroke: strokesIter->second)
-            {
-                foundIt = stroke.add(e);
-                if (foundIt)
-                    break;
-            }
-        }
+bool PointerHistoryRing::hasPointerId(std::size_t pointerId) const
+{
+    return _findPointer(pointerId) != NPOS;
+}
 
-        if (!foundIt)
-            ofLogError("PointerDebugRenderer::add") << "The sequence to be updated was nowhere to be found. This probably should not happen.";
 
-        return;
-    }
+void PointerHistoryRing::add(const PointerEventArgs& pointerEvent)
+{
+    std::size_t index = (_first + _size) % _slots.size();
+    Slot& slot = _slots[index];
 
-    // Process all events.
-    if (strokesIter == _strokes.end())
+    if (full())
     {
-        bool result;
-        std::tie(strokesIter, result) = _strokes.insert(std::make_pair(e.pointerId(), std::vector<PointerStroke>()));
-    }
+        // The oldest event is also the first of its pointer's events.
+        std::size_t pointerIndex = _findPointer(slot.event.pointerId());
+        PointerList& list = _pointers[pointerIndex].list;
 
-    if (strokesIter->second.empty() || strokesIter->second.back().isFinished())
-    {
-        strokesIter->second.push_back(PointerStroke());
-    }
+        list.first = slot.pointerNext;
+        --list.size;
 
-    // Get a reference to the current stroke.
-    auto& stroke = strokesIter->second.back();
+        if (list.size == 0)
+            _erasePointer(pointerIndex);
 
-    if (!stroke.add(e))
-    {
-        ofLogError("PointerDebugRenderer::add") << "Could not add event.";
+        _first = (_first + 1) % _slots.size();
+        --_size;
+        ++_numOverwrittenEvents;
     }
-}
 
+    // Assignment reuses the sample storage reserved for the slot.
+    slot.event = pointerEvent;
+    slot.pointerNext = NPOS;
 
-const std::map<std::size_t, std::vector<PointerStroke>>& PointerDebugRenderer::strokes() const
-{
-    return _strokes;
+    PointerList& list = _addPointer(pointerEvent.pointerId());
+
+    if (list.size > 0)
+        _slots[list.last].pointerNext = index;
+    else
+        list.first = index;
+
+    list.last = index;
+    ++list.size;
+
+    ++_size;
 }
 
 
-PointerEventCollection::PointerEventCollection()
+uint64_t PointerHistoryRing::numOverwrittenEvents() const
 {
+    return _numOverwrittenEvents;
 }
 
 
-PointerEventCollection::~PointerEventCollection()
+const PointerEventArgs& PointerHistoryRing::operator [] (std::size_t index) const
 {
+    return _slots[(_first + index) % _slots.size()].event;
 }
 
 
-std::size_t PointerEventCollection::size() const
+PointerHistoryRing::EventRange PointerHistoryRing::eventRange() const
 {
-    return _events.size();
+    return EventRange(const_iterator(this, _size > 0 ? _first : NPOS, false));
 }
 
 
-bool PointerEventCollection::empty() const
+PointerHistoryRing::EventRange PointerHistoryRing::eventRangeForPointerId(std::size_t pointerId) const
 {
-    return _events.empty();
+    std::size_t index = _findPointer(pointerId);
+
+    if (index == NPOS)
+        return EventRange(const_iterator(this, NPOS, true));
+
+    return EventRange(const_iterator(this, _pointers[index].list.first, true));
 }
 
 
-void PointerEventCollection::clear()
+std::vector<PointerEventArgs> PointerHistoryRing::events() const
 {
-    _events.clear();
-    _eventsForPointerId.clear();
+    auto range = eventRange();
+    return std::vector<PointerEventArgs>(range.begin(), range.end());
 }
 
 
-std::size_t PointerEventCollection::numPointers() const
+std::vector<PointerEventArgs> PointerHistoryRing::eventsForPointerId(std::size_t pointerId) const
 {
-    return _eventsForPointerId.size();
+    auto range = eventRangeForPointerId(pointerId);
+    return std::vector<PointerEventArgs>(range.begin(), range.end());
 }
 
 
-bool PointerEventCollection::hasPointerId(std::size_t pointerId)
+const PointerEventArgs* PointerHistoryRing::firstEventForPointerId(std::size_t pointerId) const
 {
-    return _eventsForPointerId.find(pointerId) != _eventsForPointerId.end();
+    std::size_t index = _findPointer(pointerId);
+
+    if (index != NPOS)
+        return &_slots[_pointers[index].list.first].event;
+
+    return nullptr;
 }
 
 
-void PointerEventCollection::add(const PointerEventArgs& pointerEvent)
+const PointerEventArgs* PointerHistoryRing::lastEventForPointerId(std::size_t pointerId) const
 {
-    _events.push_back(pointerEvent);
+    std::size_t index = _findPointer(pointerId);
 
-    auto iter = _eventsForPointerId.find(pointerEvent.pointerId());
-
-    if (iter != _eventsForPointerId.end())
-        iter->second.push_back(&_events.back());
-    else
-        _eventsForPointerId[pointerEvent.pointerId()] = { &_events.back() };
+    if (index != NPOS)
+        return &_slots[_pointers[index].list.last].event;
 
+    return nullptr;
 }
 
 
-void PointerEventCollection::removeEventsForPointerId(std::size_t pointerId)
+std::size_t PointerHistoryRing::_next(std::size_t index, bool pointerOnly) const
 {
-    _eventsForPointerId.erase(pointerId);
+    if (pointerOnly)
+        return _slots[index].pointerNext;
 
-    auto iter = _events.begin();
+    std::size_t last = (_first + _size - 1) % _slots.size();
 
-    while (iter != _events.end())
-    {
-        if (iter->pointerId() == pointerId)
-            iter = _events.erase(iter);
-        else
-            ++iter;
-    }
+    return index == last ? NPOS : (index + 1) % _slots.size();
 }
 
 
-std::vector<PointerEventArgs> PointerEventCollection::events() const
+std::size_t PointerHistoryRing::_home(std::size_t pointerId) const
 {
-    return _events;
+    // Mix the bits, as pointer ids are often small, sequential integers.
+    uint64_t hash = uint64_t(pointerId);
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return std::size_t(hash % _pointers.size());
 }
 
 
-std::vector<PointerEventArgs> PointerEventCollection::eventsForPointerId(std::size_t pointerId) const
+std::size_t PointerHistoryRing::_findPointer(std::size_t pointerId) const
 {
-    std::vector<PointerEventArgs> results;
+    std::size_t index = _home(pointerId);
 
-    auto iter = _eventsForPointerId.find(pointerId);
-
-    if (iter != _eventsForPointerId.end())
+    while (_pointers[index].list.size > 0)
     {
-        for (auto* event: iter->second)
-            results.push_back(*event);
+        if (_pointers[index].pointerId == pointerId)
+            return index;
+
+        index = (index + 1) % _pointers.size();
     }
 
-    return results;
+    return NPOS;
 }
 
 
-const PointerEventArgs* PointerEventCollection::firstEventForPointerId(std::size_t pointerId) const
+PointerHistoryRing::PointerList& PointerHistoryRing::_addPointer(std::size_t pointerId)
 {
-    auto iter = _eventsForPointerId.find(pointerId);
+    std::size_t index = _home(pointerId);
 
-    if (iter != _eventsForPointerId.end())
+    while (_pointers[index].list.size > 0)
     {
-        return iter->second.front();
+        if (_pointers[index].pointerId == pointerId)
+            return _pointers[index].list;
+
+        index = (index + 1) % _pointers.size();
     }
 
-    return nullptr;
+    _pointers[index].pointerId = pointerId;
+    ++_numPointers;
+    return _pointers[index].list;
 }
 
 
-const PointerEventArgs* PointerEventCollection::lastEventForPointerId(std::size_t pointerId) const
+void PointerHistoryRing::_erasePointer(std::size_t index)
 {
-    auto iter = _eventsForPointerId.find(pointerId);
+    // Shift later entries back into the hole, so lookups never need
+    // tombstones and the table does not degrade as pointer ids change.
+    std::size_t hole = index;
+    std::size_t next = (hole + 1) % _pointers.size();
 
-    if (iter != _eventsForPointerId.end())
+    while (_pointers[next].list.size > 0)
     {
-        return iter->second.back();
+        std::size_t home = _home(_pointers[next].pointerId);
+
+        bool canMove = hole < next ? (home <= hole || home > next)
+                                   : (home <= hole && home > next);
+
+        if (canMove)
+        {
+            _pointers[hole] = _pointers[next];
+            hole = next;
+        }
+
+        next = (next + 1) % _pointers.size();
     }
 
-    return nullptr;
+    _pointers[hole] = PointerEntry();
+    --_numPointers;
 }
 
 
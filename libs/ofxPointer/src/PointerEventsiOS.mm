@@ -19,38 +19,35 @@
 using namespace ofx;
 
 
-UITouchProperties toUITouchProperties(const std::set<std::string>& properties)
+UITouchProperties toUITouchProperties(PointerPropertyMask properties)
 {
     UITouchProperties result = 0;
 
-    for (const auto& property: properties)
-    {
-        if (property == PointerEventArgs::PROPERTY_PRESSURE)
-            result &= UITouchPropertyForce;
-        else if (property == PointerEventArgs::PROPERTY_TILT_X || property == PointerEventArgs::PROPERTY_TILT_Y)
-            result &= (UITouchPropertyAzimuth & UITouchPropertyAltitude);
-        else if (property == PointerEventArgs::PROPERTY_POSITION)
-            result &= UITouchPropertyLocation;
-        else
-            ofLogWarning("toUITouchProperties") << "Unknown UITouchProperty: " << property;
-    }
+    if (properties & POINTER_PROPERTY_PRESSURE)
+        result |= UITouchPropertyForce;
+
+    if (properties & (POINTER_PROPERTY_TILT_X | POINTER_PROPERTY_TILT_Y))
+        result |= (UITouchPropertyAzimuth | UITouchPropertyAltitude);
+
+    if (properties & POINTER_PROPERTY_POSITION)
+        result |= UITouchPropertyLocation;
 
     return result;
 }
 
 
-std::set<std::string> toPopertySet(UITouchProperties properties)
+PointerPropertyMask toPointerPropertyMask(UITouchProperties properties)
 {
-    std::set<std::string> result;
+    PointerPropertyMask result = POINTER_PROPERTY_NONE;
 
     if (properties & UITouchPropertyForce)
-        result.insert(PointerEventArgs::PROPERTY_PRESSURE);
+        result |= POINTER_PROPERTY_PRESSURE;
 
     if (properties & UITouchPropertyAzimuth || properties & UITouchPropertyAltitude)
-        result.insert({ PointerEventArgs::PROPERTY_TILT_X, PointerEventArgs::PROPERTY_TILT_Y });
+        result |= (POINTER_PROPERTY_TILT_X | POINTER_PROPERTY_TILT_Y);
 
     if (properties & UITouchPropertyLocation)
-        result.insert(PointerEventArgs::PROPERTY_POSITION);
+        result |= POINTER_PROPERTY_POSITION;
 
     return result;
 }
@@ -58,47 +55,13 @@ std::set<std::string> toPopertySet(UITouchProperties properties)
 
 bool dispatchPointerEvent(ofAppBaseWindow* window, PointerEventArgs& e)
 {
-    bool consumed = false;
-
     ofx::PointerEvents* events = ofx::PointerEventsManager::instance().eventsForWindow(window);
 
     if (events)
-    {
-        // All pointer events get dispatched via pointerEvent.
-        consumed = ofNotifyEvent(events->pointerEvent, e, window);
+        return events->onPointerEvent(window, e);
 
-        // If the pointer was not consumed, then send it along to the standard five.
-        if (!consumed)
-        {
-            if (e.eventType() == PointerEventArgs::POINTER_DOWN)
-            {
-                consumed = ofNotifyEvent(events->pointerDown, e, window);
-            }
-            else if (e.eventType() == PointerEventArgs::POINTER_UP)
-            {
-                consumed = ofNotifyEvent(events->pointerUp, e, window);
-            }
-            else if (e.eventType() == PointerEventArgs::POINTER_MOVE)
-            {
-                consumed = ofNotifyEvent(events->pointerMove, e, window);
-            }
-            else if (e.eventType() == PointerEventArgs::POINTER_CANCEL)
-            {
-                consumed = ofNotifyEvent(events->pointerCancel, e, window);
-            }
-            else if (e.eventType() == PointerEventArgs::POINTER_UPDATE)
-            {
-                consumed = ofNotifyEvent(events->pointerUpdate, e, window);
-            }
-        }
-    }
-    else
-    {
-        ofLogError("PointerViewIOS::touchesEnded") << "Invalid event, passing.";
-    }
-
-    // TODO address consumeLegacy events.
-    return /*events->consumeLegacyEvents ||*/ consumed;
+    ofLogError("PointerViewIOS::touchesEnded") << "Invalid event, passing.";
+    return false;
 }
 
 
@@ -125,8 +88,6 @@ bool dispatchPointerEvent(ofAppBaseWindow* window, PointerEventArgs& e)
             _viewEAGL = [ofxiOSEAGLView getInstance];
     }
 
-    _startTimeSeconds = [[NSProcessInfo processInfo] systemUptime];
-
     [self resetTouches];
 
     return self;
@@ -329,14 +290,14 @@ bool dispatchPointerEvent(ofAppBaseWindow* window, PointerEventArgs& e)
 
     uint64_t buttons = 0;
 
-    std::string eventType = PointerEventArgs::EVENT_TYPE_UNKNOWN;
+    PointerEventType eventType = PointerEventType::UNKNOWN;
     uint64_t detail = 0;
 
     uint64_t sequenceIndex = [[touch estimationUpdateIndex] unsignedLongLongValue];
 
-    std::set<std::string> estimatedProperties = toPopertySet([touch estimatedProperties]);
+    PointerPropertyMask estimatedProperties = toPointerPropertyMask([touch estimatedProperties]);
 
-    std::set<std::string> estimatedPropertiesExpectingUpdates = toPopertySet([touch estimatedPropertiesExpectingUpdates]);
+    PointerPropertyMask estimatedPropertiesExpectingUpdates = toPointerPropertyMask([touch estimatedPropertiesExpectingUpdates]);
 
     int64_t pointerIndex = _pointerIndex;
 
@@ -344,7 +305,7 @@ bool dispatchPointerEvent(ofAppBaseWindow* window, PointerEventArgs& e)
     {
         case UITouchPhaseBegan:
         {
-            eventType = PointerEventArgs::POINTER_DOWN;
+            eventType = PointerEventType::POINTER_DOWN;
             buttons |= (1 << OF_MOUSE_BUTTON_1);
             if (_activePointerIndices[[touch type]].empty())
                 _primaryPointerIndices[[touch type]] = pointerIndex;
@@ -354,19 +315,19 @@ bool dispatchPointerEvent(ofAppBaseWindow* window, PointerEventArgs& e)
         case UITouchPhaseMoved:
         case UITouchPhaseStationary:
         {
-            eventType = PointerEventArgs::POINTER_MOVE;
+            eventType = PointerEventType::POINTER_MOVE;
             buttons |= (1 << OF_MOUSE_BUTTON_1);
             break;
         }
         case UITouchPhaseEnded:
         {
-            eventType = PointerEventArgs::POINTER_UP;
+            eventType = PointerEventType::POINTER_UP;
             _activePointerIndices[[touch type]].erase(pointerIndex);
             break;
         }
         case UITouchPhaseCancelled:
         {
-            eventType = PointerEventArgs::POINTER_CANCEL;
+            eventType = PointerEventType::POINTER_CANCEL;
             _activePointerIndices[[touch type]].erase(pointerIndex);
             break;
         }
@@ -375,7 +336,7 @@ bool dispatchPointerEvent(ofAppBaseWindow* window, PointerEventArgs& e)
     // If this is an update, we change its event type.
     if (_isUpdate)
     {
-        eventType = PointerEventArgs::POINTER_UPDATE;
+        eventType = PointerEventType::POINTER_UPDATE;
         // TODO ... this shouldn't happen.
         if ([touch estimatedPropertiesExpectingUpdates] > 0)
             assert(false);
@@ -401,24 +362,24 @@ bool dispatchPointerEvent(ofAppBaseWindow* window, PointerEventArgs& e)
     bool isCoalesced = _isCoalesced;
     bool isPrimary = (pointerIndex == _primaryPointerIndices[[touch type]]);
 
-    std::string deviceType = PointerEventArgs::TYPE_UNKNOWN;
+    PointerDeviceType deviceType = PointerDeviceType::UNKNOWN;
 
     switch ([touch type])
     {
         case UITouchTypeDirect:
         {
-            deviceType = PointerEventArgs::TYPE_TOUCH;
+            deviceType = PointerDeviceType::TOUCH;
             break;
         }
         case UITouchTypeIndirect:
         {
-            deviceType = PointerEventArgs::TYPE_MOUSE;
+            deviceType = PointerDeviceType::MOUSE;
             break;
         }
 #if defined(__IPHONE_9_1)
         case UITouchTypeStylus:
         {
-            deviceType = PointerEventArgs::TYPE_PEN;
+            deviceType = PointerDeviceType::PEN;
             // Azimuth angle. Valid only for stylus touch types. Zero radians points along the positive X axis.
             // Passing a nil for the view parameter will return the azimuth relative to the touch's window.
             CGFloat azimuthRad = [touch azimuthAngleInView:view];
@@ -459,22 +420,20 @@ bool dispatchPointerEvent(ofAppBaseWindow* window, PointerEventArgs& e)
                      tiltXDeg,
                      tiltYDeg);
 
-    uint64_t modifiers = 0;
+    ofx::PointerEvents* events = ofx::PointerEventsManager::instance().eventsForWindow(self->_window);
 
-    modifiers |= ofGetKeyPressed(OF_KEY_CONTROL) ? OF_KEY_CONTROL : 0;
-    modifiers |= ofGetKeyPressed(OF_KEY_ALT)     ? OF_KEY_ALT     : 0;
-    modifiers |= ofGetKeyPressed(OF_KEY_SHIFT)   ? OF_KEY_SHIFT   : 0;
-    modifiers |= ofGetKeyPressed(OF_KEY_SUPER)   ? OF_KEY_SUPER   : 0;
+    // Use the modifiers tracked by the PointerEvents for this window.
+    uint16_t modifiers = events->modifiers();
 
-    // Convert seconds to milliseconds.
-    NSTimeInterval timestampSeconds = [touch timestamp];
-    NSTimeInterval elapsedTimestampSeconds = timestampSeconds - _startTimeSeconds;
-    uint64_t timestampMicros = elapsedTimestampSeconds * 1000000.0;
+    // Touch timestamps are hardware timestamps in seconds since system boot.
+    // Convert their age to the PointerEvents clock.
+    NSTimeInterval ageSeconds = std::max(0.0, [[NSProcessInfo processInfo] systemUptime] - [touch timestamp]);
+    uint64_t timestampMicros = events->clock()->timestampMicrosForAge(ageSeconds * 1000000.0);
 
     std::size_t deviceId = 0;
     uint64_t button = 0;
 
-    std::vector<PointerEventArgs> coalescedPointerEvents;
+    PointerSampleBuffer coalescedPointerEvents;
 
     if (event)
     {
@@ -482,28 +441,30 @@ bool dispatchPointerEvent(ofAppBaseWindow* window, PointerEventArgs& e)
         UITouch* thisTouch = [coalescedTouchesForTouch lastObject];
         for (UITouch* _touch in coalescedTouchesForTouch)
         {
+            // Samples have no coalesced or predicted samples of their own, so
+            // no event is passed.
             coalescedPointerEvents.push_back([self toPointerEventArgs:view
                                                             withTouch:_touch
-                                                            withEvent:event
+                                                            withEvent:nil
                                                      withPointerIndex:pointerIndex
                                                         withCoalesced:(_touch != thisTouch)
                                                         withPredicted:false
-                                                           withUpdate:false]);
+                                                           withUpdate:false].toPointerSample());
         }
     }
 
-    std::vector<PointerEventArgs> predictedPointerEvents;
+    PointerSampleBuffer predictedPointerEvents;
 
     if (event)
     {
         for (UITouch* _touch in [event predictedTouchesForTouch:touch])
             predictedPointerEvents.push_back([self toPointerEventArgs:view
                                                             withTouch:_touch
-                                                            withEvent:event
+                                                            withEvent:nil
                                                      withPointerIndex:pointerIndex
                                                         withCoalesced:false
                                                         withPredicted:true
-                                                           withUpdate:false]);
+                                                           withUpdate:false].toPointerSample());
     }
 
     const void* eventSource = self->_window;
@@ -511,7 +472,7 @@ bool dispatchPointerEvent(ofAppBaseWindow* window, PointerEventArgs& e)
     std::size_t pointerId = 0;
     hash_combine(pointerId, deviceId);
     hash_combine(pointerId, pointerIndex);
-    hash_combine(pointerId, deviceType);
+    hash_combine(pointerId, to_string(deviceType));
 
     return PointerEventArgs(eventSource,
                             eventType,
@@ -529,8 +490,8 @@ bool dispatchPointerEvent(ofAppBaseWindow* window, PointerEventArgs& e)
                             button,
                             buttons,
                             modifiers,
-                            coalescedPointerEvents,
-                            predictedPointerEvents,
+                            coalescedPointerEvents.samples(),
+                            predictedPointerEvents.samples(),
                             estimatedProperties,
                             estimatedPropertiesExpectingUpdates);
 }
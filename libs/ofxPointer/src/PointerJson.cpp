@@ -0,0 +1,1163 @@
+//
+// Copyright (c) 2009 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#include "ofx/PointerJson.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+
+namespace ofx {
+namespace {
+
+
+/// \brief A minimal pull parser for JSON text.
+///
+/// Values are parsed in place as they are requested. Strings without escapes
+/// are returned as views of the text.
+class JsonParser
+{
+public:
+    JsonParser(const char* data, const char* end):
+        _data(data),
+        _end(end)
+    {
+    }
+
+    /// \returns true if only whitespace remains.
+    bool atEnd()
+    {
+        _skipWhitespace();
+        return _data == _end;
+    }
+
+    /// \brief The maximum nesting depth of objects and arrays.
+    static constexpr std::size_t MAX_DEPTH = 64;
+
+    /// \brief Parse an object, calling onMember(key, size) for each member.
+    ///
+    /// onMember must parse or skip the member's value.
+    template <typename Function>
+    bool parseObject(Function onMember)
+    {
+        if (_depth == MAX_DEPTH)
+            return false;
+
+        ++_depth;
+        bool result = _parseObject(onMember);
+        --_depth;
+        return result;
+    }
+
+    /// \brief Parse an array, calling onElement() for each element.
+    ///
+    /// onElement must parse or skip the element.
+    template <typename Function>
+    bool parseArray(Function onElement)
+    {
+        if (_depth == MAX_DEPTH)
+            return false;
+
+        ++_depth;
+        bool result = _parseArray(onElement);
+        --_depth;
+        return result;
+    }
+
+    /// \brief Parse a string.
+    /// \param value The string, valid until the next string is parsed.
+    /// \param size The size of the string.
+    bool parseString(const char*& value, std::size_t& size)
+    {
+        if (!_expect('"'))
+            return false;
+
+        const char* begin = _data;
+
+        while (_data != _end && *_data != '"' && *_data != '\\')
+            ++_data;
+
+        if (_data == _end)
+            return false;
+
+        if (*_data == '"')
+        {
+            value = begin;
+            size = std::size_t(_data - begin);
+            ++_data;
+            return true;
+        }
+
+        // Decode escapes into the scratch string.
+        _string.assign(begin, _data);
+
+        while (_data != _end && *_data != '"')
+        {
+            if (*_data != '\\')
+            {
+                _string.push_back(*_data++);
+                continue;
+            }
+
+            if (++_data == _end)
+                return false;
+
+            switch (*_data++)
+            {
+                case '"': _string.push_back('"'); break;
+                case '\\': _string.push_back('\\'); break;
+                case '/': _string.push_back('/'); break;
+                case 'b': _string.push_back('\b'); break;
+                case 'f': _string.push_back('\f'); break;
+                case 'n': _string.push_back('\n'); break;
+                case 'r': _string.push_back('\r'); break;
+                case 't': _string.push_back('\t'); break;
+                case 'u':
+                {
+                    uint32_t codePoint = 0;
+
+                    if (!_parseHex(codePoint))
+                        return false;
+
+                    // Combine surrogate pairs.
+                    if (codePoint >= 0xD800 && codePoint < 0xDC00)
+                    {
+                        uint32_t low = 0;
+
+                        if (_end - _data < 2 || _data[0] != '\\' || _data[1] != 'u')
+                            return false;
+
+                        _data += 2;
+
+                        if (!_parseHex(low) || low < 0xDC00 || low >= 0xE000)
+                            return false;
+
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+
+                    _appendUtf8(codePoint);
+                    break;
+                }
+                default:
+                    return false;
+            }
+        }
+
+        if (_data == _end)
+            return false;
+
+        ++_data;
+        value = _string.data();
+        size = _string.size();
+        return true;
+    }
+
+    /// \brief Parse a string into a std::string.
+    bool parseString(std::string& value)
+    {
+        const char* data = nullptr;
+        std::size_t size = 0;
+
+        if (!parseString(data, size))
+            return false;
+
+        value.assign(data, size);
+        return true;
+    }
+
+    /// \brief Parse a boolean.
+    bool parseBool(bool& value)
+    {
+        _skipWhitespace();
+
+        if (_literal("true"))
+            value = true;
+        else if (_literal("false"))
+            value = false;
+        else if (_literal("null"))
+            value = false;
+        else
+            return false;
+
+        return true;
+    }
+
+    /// \brief Parse a number as an integer, truncating any fraction.
+    template <typename T>
+    bool parseInteger(T& value)
+    {
+        bool isNegative = false;
+        uint64_t mantissa = 0;
+        int exponent = 0;
+        bool isNull = false;
+
+        if (!_parseNumber(isNegative, mantissa, exponent, isNull))
+            return false;
+
+        if (isNull)
+        {
+            value = T(0);
+            return true;
+        }
+
+        if (exponent != 0)
+        {
+            double number = _toDouble(isNegative, mantissa, exponent);
+            value = T(isNegative ? int64_t(number) : int64_t(uint64_t(number)));
+        }
+        else
+        {
+            value = isNegative ? T(-int64_t(mantissa)) : T(mantissa);
+        }
+
+        return true;
+    }
+
+    /// \brief Parse a number as a float. Null is parsed as NaN.
+    bool parseFloat(float& value)
+    {
+        bool isNegative = false;
+        uint64_t mantissa = 0;
+        int exponent = 0;
+        bool isNull = false;
+
+        if (!_parseNumber(isNegative, mantissa, exponent, isNull))
+            return false;
+
+        value = isNull ? std::numeric_limits<float>::quiet_NaN() : float(_toDouble(isNegative, mantissa, exponent));
+        return true;
+    }
+
+    /// \brief Skip any value.
+    bool skipValue()
+    {
+        _skipWhitespace();
+
+        if (_data == _end)
+            return false;
+
+        switch (*_data)
+        {
+            case '{':
+                return parseObject([&](const char*, std::size_t) { return skipValue(); });
+            case '[':
+                return parseArray([&]() { return skipValue(); });
+            case '"':
+            {
+                const char* value = nullptr;
+                std::size_t size = 0;
+                return parseString(value, size);
+            }
+            case 't':
+            case 'f':
+            {
+                bool value = false;
+                return parseBool(value);
+            }
+            default:
+            {
+                bool isNegative = false;
+                uint64_t mantissa = 0;
+                int exponent = 0;
+                bool isNull = false;
+                return _parseNumber(isNegative, mantissa, exponent, isNull);
+            }
+        }
+    }
+
+private:
+    template <typename Function>
+    bool _parseObject(Function onMember)
+    {
+        if (!_expect('{'))
+            return false;
+
+        if (_peek('}'))
+            return true;
+
+        do
+        {
+            const char* key = nullptr;
+            std::size_t size = 0;
+
+            if (!parseString(key, size) || !_expect(':') || !onMember(key, size))
+                return false;
+        }
+        while (_peek(','));
+
+        return _expect('}');
+    }
+
+    template <typename Function>
+    bool _parseArray(Function onElement)
+    {
+        if (!_expect('['))
+            return false;
+
+        if (_peek(']'))
+            return true;
+
+        do
+        {
+            if (!onElement())
+                return false;
+        }
+        while (_peek(','));
+
+        return _expect(']');
+    }
+
+    void _skipWhitespace()
+    {
+        while (_data != _end && (*_data == ' ' || *_data == '\t' || *_data == '\n' || *_data == '\r'))
+            ++_data;
+    }
+
+    bool _expect(char c)
+    {
+        _skipWhitespace();
+
+        if (_data == _end || *_data != c)
+            return false;
+
+        ++_data;
+        return true;
+    }
+
+    bool _peek(char c)
+    {
+        _skipWhitespace();
+
+        if (_data != _end && *_data == c)
+        {
+            ++_data;
+            return true;
+        }
+
+        return false;
+    }
+
+    template <std::size_t N>
+    bool _literal(const char (&literal)[N])
+    {
+        if (std::size_t(_end - _data) < N - 1 || std::memcmp(_data, literal, N - 1) != 0)
+            return false;
+
+        _data += N - 1;
+        return true;
+    }
+
+    bool _parseHex(uint32_t& value)
+    {
+        if (_end - _data < 4)
+            return false;
+
+        value = 0;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            char c = *_data++;
+            value <<= 4;
+
+            if (c >= '0' && c <= '9')
+                value |= uint32_t(c - '0');
+            else if (c >= 'a' && c <= 'f')
+                value |= uint32_t(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F')
+                value |= uint32_t(c - 'A' + 10);
+            else
+                return false;
+        }
+
+        return true;
+    }
+
+    void _appendUtf8(uint32_t codePoint)
+    {
+        if (codePoint < 0x80)
+        {
+            _string.push_back(char(codePoint));
+        }
+        else if (codePoint < 0x800)
+        {
+            _string.push_back(char(0xC0 | (codePoint >> 6)));
+            _string.push_back(char(0x80 | (codePoint & 0x3F)));
+        }
+        else if (codePoint < 0x10000)
+        {
+            _string.push_back(char(0xE0 | (codePoint >> 12)));
+            _string.push_back(char(0x80 | ((codePoint >> 6) & 0x3F)));
+            _string.push_back(char(0x80 | (codePoint & 0x3F)));
+        }
+        else
+        {
+            _string.push_back(char(0xF0 | (codePoint >> 18)));
+            _string.push_back(char(0x80 | ((codePoint >> 12) & 0x3F)));
+            _string.push_back(char(0x80 | ((codePoint >> 6) & 0x3F)));
+            _string.push_back(char(0x80 | (codePoint & 0x3F)));
+        }
+    }
+
+    /// \brief Parse a number as a decimal mantissa and exponent.
+    ///
+    /// Digits beyond the precision of the mantissa are dropped.
+    bool _parseNumber(bool& isNegative, uint64_t& mantissa, int& exponent, bool& isNull)
+    {
+        _skipWhitespace();
+
+        if (_literal("null"))
+        {
+            isNull = true;
+            return true;
+        }
+
+        isNegative = _data != _end && *_data == '-';
+
+        if (isNegative)
+            ++_data;
+
+        const char* digits = _data;
+
+        for (; _data != _end && *_data >= '0' && *_data <= '9'; ++_data)
+        {
+            if (!_accumulate(mantissa, *_data))
+                ++exponent;
+        }
+
+        if (_data == digits)
+            return false;
+
+        if (_data != _end && *_data == '.')
+        {
+            const char* fraction = ++_data;
+
+            for (; _data != _end && *_data >= '0' && *_data <= '9'; ++_data)
+            {
+                if (_accumulate(mantissa, *_data))
+                    --exponent;
+            }
+
+            if (_data == fraction)
+                return false;
+        }
+
+        if (_data != _end && (*_data == 'e' || *_data == 'E'))
+        {
+            ++_data;
+
+            bool isNegativeExponent = _data != _end && *_data == '-';
+
+            if (_data != _end && (*_data == '-' || *_data == '+'))
+                ++_data;
+
+            const char* exponentDigits = _data;
+            int value = 0;
+
+            for (; _data != _end && *_data >= '0' && *_data <= '9'; ++_data)
+            {
+                if (value < 10000)
+                    value = value * 10 + (*_data - '0');
+            }
+
+            if (_data == exponentDigits)
+                return false;
+
+            exponent += isNegativeExponent ? -value : value;
+        }
+
+        return true;
+    }
+
+    /// \brief Add a digit to a mantissa if it fits.
+    /// \returns true if the digit was added.
+    static bool _accumulate(uint64_t& mantissa, char digit)
+    {
+        uint64_t value = uint64_t(digit - '0');
+
+        if (mantissa > (std::numeric_limits<uint64_t>::max() - value) / 10)
+            return false;
+
+        mantissa = mantissa * 10 + value;
+        return true;
+    }
+
+    /// \brief Convert a decimal mantissa and exponent to a double.
+    ///
+    /// This is exact for mantissas up to 2^53 and exponents up to 22, which
+    /// covers float values written with up to 17 significant digits.
+    static double _toDouble(bool isNegative, uint64_t mantissa, int exponent)
+    {
+        static const double POWERS[] =
+        {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+
+        double value = double(mantissa);
+
+        if (exponent < 0 && exponent >= -22)
+            value /= POWERS[-exponent];
+        else if (exponent > 0 && exponent <= 22)
+            value *= POWERS[exponent];
+        else if (exponent != 0)
+            value *= std::pow(10.0, exponent);
+
+        return isNegative ? -value : value;
+    }
+
+    /// \brief The remaining text.
+    const char* _data = nullptr;
+
+    /// \brief The end of the text.
+    const char* _end = nullptr;
+
+    /// \brief The decoded string, if it contained escapes.
+    std::string _string;
+
+    /// \brief The number of objects and arrays being parsed.
+    std::size_t _depth = 0;
+
+};
+
+
+} // namespace
+
+
+/// \brief Compare a parsed key with a literal.
+template <std::size_t N>
+static bool isKey(const char* key, std::size_t size, const char (&literal)[N])
+{
+    return size == N - 1 && std::memcmp(key, literal, N - 1) == 0;
+}
+
+
+template <std::size_t N>
+static void appendLiteral(std::string& buffer, const char (&literal)[N])
+{
+    buffer.append(literal, N - 1);
+}
+
+
+static void appendUnsigned(std::string& buffer, uint64_t value)
+{
+    char digits[20];
+    char* p = digits + sizeof(digits);
+
+    do
+    {
+        *--p = char('0' + value % 10);
+        value /= 10;
+    }
+    while (value != 0);
+
+    buffer.append(p, std::size_t(digits + sizeof(digits) - p));
+}
+
+
+static void appendSigned(std::string& buffer, int64_t value)
+{
+    if (value < 0)
+    {
+        buffer.push_back('-');
+        appendUnsigned(buffer, uint64_t(0) - uint64_t(value));
+    }
+    else
+    {
+        appendUnsigned(buffer, uint64_t(value));
+    }
+}
+
+
+static void appendFloat(std::string& buffer, float value)
+{
+    // JSON has no representation for these, so write null like to_json().
+    if (!std::isfinite(value))
+    {
+        appendLiteral(buffer, "null");
+        return;
+    }
+
+    // Integral values, such as zero, are common and fast to write.
+    if (value == std::trunc(value) && std::fabs(value) < 1e9f)
+    {
+        if (std::signbit(value) && value == 0)
+            appendLiteral(buffer, "-0.0");
+        else
+            appendSigned(buffer, int64_t(value));
+
+        return;
+    }
+
+    // Nine significant digits are enough to read back the same float.
+    char digits[32];
+    int size = std::snprintf(digits, sizeof(digits), "%.9g", double(value));
+
+    // Ignore the locale's decimal separator.
+    for (int i = 0; i < size; ++i)
+    {
+        if (digits[i] == ',')
+            digits[i] = '.';
+    }
+
+    buffer.append(digits, std::size_t(size));
+}
+
+
+static void appendBool(std::string& buffer, bool value)
+{
+    if (value)
+        appendLiteral(buffer, "true");
+    else
+        appendLiteral(buffer, "false");
+}
+
+
+static void appendString(std::string& buffer, const std::string& value)
+{
+    static const char HEX[] = "0123456789abcdef";
+
+    buffer.push_back('"');
+
+    for (char c: value)
+    {
+        switch (c)
+        {
+            case '"': appendLiteral(buffer, "\\\""); break;
+            case '\\': appendLiteral(buffer, "\\\\"); break;
+            case '\b': appendLiteral(buffer, "\\b"); break;
+            case '\f': appendLiteral(buffer, "\\f"); break;
+            case '\n': appendLiteral(buffer, "\\n"); break;
+            case '\r': appendLiteral(buffer, "\\r"); break;
+            case '\t': appendLiteral(buffer, "\\t"); break;
+            default:
+                if (uint8_t(c) < 0x20)
+                {
+                    appendLiteral(buffer, "\\u00");
+                    buffer.push_back(HEX[uint8_t(c) >> 4]);
+                    buffer.push_back(HEX[uint8_t(c) & 0xF]);
+                }
+                else
+                {
+                    buffer.push_back(c);
+                }
+        }
+    }
+
+    buffer.push_back('"');
+}
+
+
+static void appendVec2(std::string& buffer, const glm::vec2& value)
+{
+    appendLiteral(buffer, "{\"x\":");
+    appendFloat(buffer, value.x);
+    appendLiteral(buffer, ",\"y\":");
+    appendFloat(buffer, value.y);
+    buffer.push_back('}');
+}
+
+
+static void appendPoint(std::string& buffer, const Point& point)
+{
+    const PointShape& shape = point.shape();
+
+    appendLiteral(buffer, "{\"position\":");
+    appendVec2(buffer, point.position());
+    appendLiteral(buffer, ",\"precise_position\":");
+    appendVec2(buffer, point.precisePosition());
+    appendLiteral(buffer, ",\"shape\":{\"shape_type\":");
+    appendString(buffer, to_string(shape.shapeType()));
+    appendLiteral(buffer, ",\"width\":");
+    appendFloat(buffer, shape.width());
+    appendLiteral(buffer, ",\"height\":");
+    appendFloat(buffer, shape.height());
+    appendLiteral(buffer, ",\"width_tolerance\":");
+    appendFloat(buffer, shape.widthTolerance());
+    appendLiteral(buffer, ",\"height_tolerance\":");
+    appendFloat(buffer, shape.heightTolerance());
+    appendLiteral(buffer, ",\"angle_deg\":");
+    appendFloat(buffer, shape.angleDeg());
+    appendLiteral(buffer, "},\"pressure\":");
+    appendFloat(buffer, point.pressure());
+    appendLiteral(buffer, ",\"tangential_pressure\":");
+    appendFloat(buffer, point.tangentialPressure());
+    appendLiteral(buffer, ",\"twist_deg\":");
+    appendFloat(buffer, point.twistDeg());
+    appendLiteral(buffer, ",\"tilt_x_deg\":");
+    appendFloat(buffer, point.tiltXDeg());
+    appendLiteral(buffer, ",\"tilt_y_deg\":");
+    appendFloat(buffer, point.tiltYDeg());
+    buffer.push_back('}');
+}
+
+
+static void appendProperties(std::string& buffer, PointerPropertyMask properties)
+{
+    static const std::pair<PointerProperty, const std::string*> NAMES[] =
+    {
+        { POINTER_PROPERTY_POSITION, &PointerEventArgs::PROPERTY_POSITION },
+        { POINTER_PROPERTY_PRESSURE, &PointerEventArgs::PROPERTY_PRESSURE },
+        { POINTER_PROPERTY_TILT_X, &PointerEventArgs::PROPERTY_TILT_X },
+        { POINTER_PROPERTY_TILT_Y, &PointerEventArgs::PROPERTY_TILT_Y }
+    };
+
+    buffer.push_back('[');
+
+    bool isFirst = true;
+
+    for (const auto& name: NAMES)
+    {
+        if (properties & name.first)
+        {
+            if (!isFirst)
+                buffer.push_back(',');
+
+            appendString(buffer, *name.second);
+            isFirst = false;
+        }
+    }
+
+    buffer.push_back(']');
+}
+
+
+/// \brief Append an event with the point, timing and flags of a sample.
+///
+/// Coalesced and predicted samples are written as complete events without
+/// samples of their own, like to_json().
+static void appendEvent(std::string& buffer,
+                        const PointerEventArgs& e,
+                        const PointerSample& sample,
+                        bool withSamples)
+{
+    appendLiteral(buffer, "{\"event_type\":");
+    appendString(buffer, e.eventType());
+    appendLiteral(buffer, ",\"timestamp_micros\":");
+    appendUnsigned(buffer, sample.timestampMicros);
+    appendLiteral(buffer, ",\"detail\":");
+    appendUnsigned(buffer, e.detail());
+    appendLiteral(buffer, ",\"point\":");
+    appendPoint(buffer, sample.point);
+    appendLiteral(buffer, ",\"pointer_id\":");
+    appendUnsigned(buffer, e.pointerId());
+    appendLiteral(buffer, ",\"device_id\":");
+    appendSigned(buffer, e.deviceId());
+    appendLiteral(buffer, ",\"pointer_index\":");
+    appendSigned(buffer, e.pointerIndex());
+    appendLiteral(buffer, ",\"sequence_index\":");
+    appendUnsigned(buffer, sample.sequenceIndex);
+    appendLiteral(buffer, ",\"device_type\":");
+    appendString(buffer, e.deviceType());
+    appendLiteral(buffer, ",\"is_coalesced\":");
+    appendBool(buffer, sample.isCoalesced());
+    appendLiteral(buffer, ",\"is_predicted\":");
+    appendBool(buffer, sample.isPredicted());
+    appendLiteral(buffer, ",\"is_primary\":");
+    appendBool(buffer, e.isPrimary());
+    appendLiteral(buffer, ",\"button\":");
+    appendSigned(buffer, e.button());
+    appendLiteral(buffer, ",\"buttons\":");
+    appendUnsigned(buffer, e.buttons());
+    appendLiteral(buffer, ",\"modifiers\":");
+    appendUnsigned(buffer, e.modifiers());
+
+    appendLiteral(buffer, ",\"coalesced_pointer_events\":[");
+
+    if (withSamples)
+    {
+        bool isFirst = true;
+
+        for (const auto& coalesced: e.coalescedPointerEvents())
+        {
+            if (!isFirst)
+                buffer.push_back(',');
+
+            appendEvent(buffer, e, coalesced, false);
+            isFirst = false;
+        }
+    }
+
+    appendLiteral(buffer, "],\"predicted_pointer_events\":[");
+
+    if (withSamples)
+    {
+        bool isFirst = true;
+
+        for (const auto& predicted: e.predictedPointerEvents())
+        {
+            if (!isFirst)
+                buffer.push_back(',');
+
+            appendEvent(buffer, e, predicted, false);
+            isFirst = false;
+        }
+    }
+
+    appendLiteral(buffer, "],\"estimated_properties\":");
+    appendProperties(buffer, sample.estimatedProperties);
+    appendLiteral(buffer, ",\"estimated_properties_expecting_updates\":");
+    appendProperties(buffer, sample.estimatedPropertiesExpectingUpdates);
+    buffer.push_back('}');
+}
+
+
+static bool parseVec2(JsonParser& parser, glm::vec2& value)
+{
+    value = glm::vec2(0, 0);
+
+    return parser.parseObject([&](const char* key, std::size_t size) {
+        if (isKey(key, size, "x"))
+            return parser.parseFloat(value.x);
+        else if (isKey(key, size, "y"))
+            return parser.parseFloat(value.y);
+
+        return parser.skipValue();
+    });
+}
+
+
+static bool parseShape(JsonParser& parser, PointShape& shape)
+{
+    PointShape::ShapeType shapeType = PointShape::ShapeType::ELLIPSE;
+    float width = 1;
+    float height = 1;
+    float widthTolerance = 0;
+    float heightTolerance = 0;
+    float angleDeg = 0;
+
+    bool isValid = parser.parseObject([&](const char* key, std::size_t size) {
+        if (isKey(key, size, "shape_type"))
+        {
+            const char* value = nullptr;
+            std::size_t valueSize = 0;
+
+            if (!parser.parseString(value, valueSize))
+                return false;
+
+            if (isKey(value, valueSize, "RECTANGLE"))
+                shapeType = PointShape::ShapeType::RECTANGLE;
+            else if (!isKey(value, valueSize, "ELLIPSE"))
+                ofLogWarning("PointerEventJsonReader::parse") << "Unknown value: " << std::string(value, valueSize);
+
+            return true;
+        }
+        else if (isKey(key, size, "width"))
+            return parser.parseFloat(width);
+        else if (isKey(key, size, "height"))
+            return parser.parseFloat(height);
+        else if (isKey(key, size, "width_tolerance"))
+            return parser.parseFloat(widthTolerance);
+        else if (isKey(key, size, "height_tolerance"))
+            return parser.parseFloat(heightTolerance);
+        else if (isKey(key, size, "angle_deg"))
+            return parser.parseFloat(angleDeg);
+
+        return parser.skipValue();
+    });
+
+    shape = PointShape(shapeType, width, height, widthTolerance, heightTolerance, angleDeg);
+    return isValid;
+}
+
+
+static bool parsePoint(JsonParser& parser, Point& point)
+{
+    glm::vec2 position(0, 0);
+    glm::vec2 precisePosition(0, 0);
+    PointShape shape;
+    float pressure = 0;
+    float tangentialPressure = 0;
+    float twistDeg = 0;
+    float tiltXDeg = 0;
+    float tiltYDeg = 0;
+
+    bool isValid = parser.parseObject([&](const char* key, std::size_t size) {
+        if (isKey(key, size, "position"))
+            return parseVec2(parser, position);
+        else if (isKey(key, size, "precise_position"))
+            return parseVec2(parser, precisePosition);
+        else if (isKey(key, size, "shape"))
+            return parseShape(parser, shape);
+        else if (isKey(key, size, "pressure"))
+            return parser.parseFloat(pressure);
+        else if (isKey(key, size, "tangential_pressure"))
+            return parser.parseFloat(tangentialPressure);
+        else if (isKey(key, size, "twist_deg"))
+            return parser.parseFloat(twistDeg);
+        else if (isKey(key, size, "tilt_x_deg"))
+            return parser.parseFloat(tiltXDeg);
+        else if (isKey(key, size, "tilt_y_deg"))
+            return parser.parseFloat(tiltYDeg);
+
+        return parser.skipValue();
+    });
+
+    point = Point(position,
+                  precisePosition,
+                  shape,
+                  pressure,
+                  tangentialPressure,
+                  twistDeg,
+                  tiltXDeg,
+                  tiltYDeg);
+
+    return isValid;
+}
+
+
+static bool parseProperties(JsonParser& parser, PointerPropertyMask& properties)
+{
+    properties = POINTER_PROPERTY_NONE;
+
+    return parser.parseArray([&]() {
+        const char* value = nullptr;
+        std::size_t size = 0;
+
+        if (!parser.parseString(value, size))
+            return false;
+
+        if (PointerEventArgs::PROPERTY_POSITION.compare(0, std::string::npos, value, size) == 0)
+            properties |= POINTER_PROPERTY_POSITION;
+        else if (PointerEventArgs::PROPERTY_PRESSURE.compare(0, std::string::npos, value, size) == 0)
+            properties |= POINTER_PROPERTY_PRESSURE;
+        else if (PointerEventArgs::PROPERTY_TILT_X.compare(0, std::string::npos, value, size) == 0)
+            properties |= POINTER_PROPERTY_TILT_X;
+        else if (PointerEventArgs::PROPERTY_TILT_Y.compare(0, std::string::npos, value, size) == 0)
+            properties |= POINTER_PROPERTY_TILT_Y;
+        else
+            ofLogWarning("PointerEventJsonReader::parse") << "Unknown property: " << std::string(value, size);
+
+        return true;
+    });
+}
+
+
+/// \brief Parse a coalesced or predicted event as a sample.
+static bool parseSample(JsonParser& parser, PointerSample& sample)
+{
+    bool isCoalesced = false;
+    bool isPredicted = false;
+
+    bool isValid = parser.parseObject([&](const char* key, std::size_t size) {
+        if (isKey(key, size, "timestamp_micros"))
+            return parser.parseInteger(sample.timestampMicros);
+        else if (isKey(key, size, "point"))
+            return parsePoint(parser, sample.point);
+        else if (isKey(key, size, "sequence_index"))
+            return parser.parseInteger(sample.sequenceIndex);
+        else if (isKey(key, size, "is_coalesced"))
+            return parser.parseBool(isCoalesced);
+        else if (isKey(key, size, "is_predicted"))
+            return parser.parseBool(isPredicted);
+        else if (isKey(key, size, "estimated_properties"))
+            return parseProperties(parser, sample.estimatedProperties);
+        else if (isKey(key, size, "estimated_properties_expecting_updates"))
+            return parseProperties(parser, sample.estimatedPropertiesExpectingUpdates);
+
+        return parser.skipValue();
+    });
+
+    sample.flags = (isCoalesced ? PointerSample::FLAG_COALESCED : PointerSample::FLAG_NONE)
+                 | (isPredicted ? PointerSample::FLAG_PREDICTED : PointerSample::FLAG_NONE);
+
+    return isValid;
+}
+
+
+static bool parseSamples(JsonParser& parser, PointerSampleBuffer& samples)
+{
+    return parser.parseArray([&]() {
+        PointerSample sample;
+
+        if (!parseSample(parser, sample))
+            return false;
+
+        samples.push_back(sample);
+        return true;
+    });
+}
+
+
+constexpr std::size_t PointerEventJsonWriter::BUFFER_SIZE;
+
+
+PointerEventJsonWriter::PointerEventJsonWriter(std::ostream& stream):
+    _stream(stream)
+{
+    _buffer.reserve(BUFFER_SIZE + BUFFER_SIZE / 4);
+}
+
+
+PointerEventJsonWriter::~PointerEventJsonWriter()
+{
+    flush();
+}
+
+
+bool PointerEventJsonWriter::write(const PointerEventArgs& e)
+{
+    append(e, _buffer);
+    ++_numEvents;
+
+    if (_buffer.size() >= BUFFER_SIZE)
+        return flush();
+
+    return _stream.good();
+}
+
+
+bool PointerEventJsonWriter::flush()
+{
+    _stream.write(_buffer.data(), _buffer.size());
+    _buffer.clear();
+    return _stream.good();
+}
+
+
+std::size_t PointerEventJsonWriter::numEvents() const
+{
+    return _numEvents;
+}
+
+
+void PointerEventJsonWriter::append(const PointerEventArgs& e, std::string& buffer)
+{
+    appendEvent(buffer, e, e.toPointerSample(), true);
+    buffer.push_back('\n');
+}
+
+
+PointerEventJsonReader::PointerEventJsonReader(std::istream& stream):
+    _stream(stream)
+{
+}
+
+
+PointerEventJsonReader::~PointerEventJsonReader()
+{
+}
+
+
+bool PointerEventJsonReader::read(PointerEventArgs& e)
+{
+    while (std::getline(_stream, _line))
+    {
+        ++_lineNumber;
+
+        if (_line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+
+        if (parse(_line.data(), _line.size(), e))
+            return true;
+
+        ofLogError("PointerEventJsonReader::read") << "Invalid event on line " << _lineNumber << ".";
+        return false;
+    }
+
+    return false;
+}
+
+
+std::size_t PointerEventJsonReader::lineNumber() const
+{
+    return _lineNumber;
+}
+
+
+bool PointerEventJsonReader::parse(const char* data, std::size_t size, PointerEventArgs& e)
+{
+    JsonParser parser(data, data + size);
+
+    std::string eventType = EventArgs::EVENT_TYPE_UNKNOWN;
+    std::string deviceType = PointerEventArgs::TYPE_UNKNOWN;
+    uint64_t detail = 0;
+    std::size_t pointerId = 0;
+    int64_t deviceId = 0;
+    int64_t pointerIndex = 0;
+    bool isPrimary = false;
+    int16_t button = 0;
+    uint16_t buttons = 0;
+    uint16_t modifiers = 0;
+    PointerSample sample;
+    bool isCoalesced = false;
+    bool isPredicted = false;
+    PointerSampleBuffer coalesced;
+    PointerSampleBuffer predicted;
+
+    bool isValid = parser.parseObject([&](const char* key, std::size_t keySize) {
+        if (isKey(key, keySize, "event_type"))
+            return parser.parseString(eventType);
+        else if (isKey(key, keySize, "timestamp_micros"))
+            return parser.parseInteger(sample.timestampMicros);
+        else if (isKey(key, keySize, "detail"))
+            return parser.parseInteger(detail);
+        else if (isKey(key, keySize, "point"))
+            return parsePoint(parser, sample.point);
+        else if (isKey(key, keySize, "pointer_id"))
+            return parser.parseInteger(pointerId);
+        else if (isKey(key, keySize, "device_id"))
+            return parser.parseInteger(deviceId);
+        else if (isKey(key, keySize, "pointer_index"))
+            return parser.parseInteger(pointerIndex);
+        else if (isKey(key, keySize, "sequence_index"))
+            return parser.parseInteger(sample.sequenceIndex);
+        else if (isKey(key, keySize, "device_type"))
+            return parser.parseString(deviceType);
+        else if (isKey(key, keySize, "is_coalesced"))
+            return parser.parseBool(isCoalesced);
+        else if (isKey(key, keySize, "is_predicted"))
+            return parser.parseBool(isPredicted);
+        else if (isKey(key, keySize, "is_primary"))
+            return parser.parseBool(isPrimary);
+        else if (isKey(key, keySize, "button"))
+            return parser.parseInteger(button);
+        else if (isKey(key, keySize, "buttons"))
+            return parser.parseInteger(buttons);
+        else if (isKey(key, keySize, "modifiers"))
+            return parser.parseInteger(modifiers);
+        else if (isKey(key, keySize, "coalesced_pointer_events"))
+            return parseSamples(parser, coalesced);
+        else if (isKey(key, keySize, "predicted_pointer_events"))
+            return parseSamples(parser, predicted);
+        else if (isKey(key, keySize, "estimated_properties"))
+            return parseProperties(parser, sample.estimatedProperties);
+        else if (isKey(key, keySize, "estimated_properties_expecting_updates"))
+            return parseProperties(parser, sample.estimatedPropertiesExpectingUpdates);
+
+        return parser.skipValue();
+    });
+
+    if (!isValid || !parser.atEnd())
+        return false;
+
+    e = PointerEventArgs::toPointerEventArgs(nullptr,
+                                             eventType,
+                                             sample.timestampMicros,
+                                             detail,
+                                             sample.point,
+                                             pointerId,
+                                             deviceId,
+                                             pointerIndex,
+                                             sample.sequenceIndex,
+                                             deviceType,
+                                             isCoalesced,
+                                             isPredicted,
+                                             isPrimary,
+                                             button,
+                                             buttons,
+                                             modifiers,
+                                             coalesced.samples(),
+                                             predicted.samples(),
+                                             sample.estimatedProperties,
+                                             sample.estimatedPropertiesExpectingUpdates);
+
+    return true;
+}
+
+
+} // namespace ofx
@@ -0,0 +1,428 @@
+//
+// Copyright (c) 2009 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#include "ofx/PointerPredictor.h"
+#include <cmath>
+
+
+namespace ofx {
+
+
+PointerPredictor::PointerPredictor(std::size_t numPredictions,
+                                   uint64_t horizonMicros):
+    _numPredictions(numPredictions),
+    _horizonMicros(horizonMicros)
+{
+}
+
+
+PointerPredictor::~PointerPredictor()
+{
+}
+
+
+void PointerPredictor::add(const PointerEventArgs& e)
+{
+    switch (e.pointerEventType())
+    {
+        case PointerEventType::POINTER_DOWN:
+            reset(e.pointerId());
+            break;
+        case PointerEventType::POINTER_MOVE:
+            break;
+        case PointerEventType::POINTER_UP:
+        case PointerEventType::POINTER_CANCEL:
+            reset(e.pointerId());
+            return;
+        default:
+            return;
+    }
+
+    auto coalesced = e.coalescedPointerEvents();
+
+    // Events that have been expanded from samples have no samples of their own.
+    if (coalesced.empty())
+    {
+        if (!e.isPredicted())
+            _add(e.pointerId(), e.toPointerSample());
+        return;
+    }
+
+    for (const auto& sample: coalesced)
+    {
+        if (!sample.isPredicted())
+            _add(e.pointerId(), sample);
+    }
+}
+
+
+std::size_t PointerPredictor::predict(const PointerEventArgs& e,
+                                      PointerSampleBuffer& predicted) const
+{
+    std::size_t count = 0;
+
+    const Point& point = e.point();
+
+    for (std::size_t i = 1; i <= _numPredictions; ++i)
+    {
+        PointerSample sample;
+        sample.timestampMicros = e.timestampMicros() + (_horizonMicros * i) / _numPredictions;
+
+        glm::vec2 position;
+
+        if (!predictPosition(e.pointerId(), sample.timestampMicros, position))
+            break;
+
+        sample.point = Point(position,
+                             position,
+                             point.shape(),
+                             point.pressure(),
+                             point.tangentialPressure(),
+                             point.twistDeg(),
+                             point.tiltXDeg(),
+                             point.tiltYDeg());
+        sample.flags = PointerSample::FLAG_PREDICTED;
+
+        predicted.push_back(sample);
+        ++count;
+    }
+
+    return count;
+}
+
+
+void PointerPredictor::setNumPredictions(std::size_t numPredictions)
+{
+    _numPredictions = numPredictions;
+}
+
+
+std::size_t PointerPredictor::getNumPredictions() const
+{
+    return _numPredictions;
+}
+
+
+void PointerPredictor::setHorizonMicros(uint64_t horizonMicros)
+{
+    _horizonMicros = horizonMicros;
+}
+
+
+uint64_t PointerPredictor::getHorizonMicros() const
+{
+    return _horizonMicros;
+}
+
+
+LinearPointerPredictor::~LinearPointerPredictor()
+{
+}
+
+
+bool LinearPointerPredictor::predictPosition(std::size_t pointerId,
+                                             uint64_t timestampMicros,
+                                             glm::vec2& position) const
+{
+    auto iter = _samples.find(pointerId);
+
+    if (iter == _samples.end() || iter->second.size() < 2)
+        return false;
+
+    const auto& s0 = iter->second[0];
+    const auto& s1 = iter->second[1];
+
+    double dt = double(s1.timestampMicros) - double(s0.timestampMicros);
+    double t = double(timestampMicros) - double(s1.timestampMicros);
+
+    glm::vec2 p0 = s0.position();
+    glm::vec2 p1 = s1.position();
+
+    position.x = p1.x + (p1.x - p0.x) * t / dt;
+    position.y = p1.y + (p1.y - p0.y) * t / dt;
+
+    return true;
+}
+
+
+void LinearPointerPredictor::reset(std::size_t pointerId)
+{
+    _samples.erase(pointerId);
+}
+
+
+void LinearPointerPredictor::clear()
+{
+    _samples.clear();
+}
+
+
+void LinearPointerPredictor::_add(std::size_t pointerId, const PointerSample& sample)
+{
+    auto& samples = _samples[pointerId];
+
+    // Samples without elapsed time can't contribute to a velocity.
+    if (!samples.empty() && sample.timestampMicros <= samples.back().timestampMicros)
+    {
+        samples.back() = sample;
+        return;
+    }
+
+    if (samples.size() == 2)
+        samples.erase(samples.begin());
+
+    samples.push_back(sample);
+}
+
+
+QuadraticPointerPredictor::~QuadraticPointerPredictor()
+{
+}
+
+
+bool QuadraticPointerPredictor::predictPosition(std::size_t pointerId,
+                                                uint64_t timestampMicros,
+                                                glm::vec2& position) const
+{
+    auto iter = _samples.find(pointerId);
+
+    if (iter == _samples.end() || iter->second.size() < 2)
+        return false;
+
+    const auto& samples = iter->second;
+    std::size_t n = samples.size();
+
+    double t2 = double(samples[n - 1].timestampMicros);
+    double t1 = double(samples[n - 2].timestampMicros);
+    double t = double(timestampMicros);
+
+    glm::vec2 p2 = samples[n - 1].position();
+    glm::vec2 p1 = samples[n - 2].position();
+
+    for (int axis = 0; axis < 2; ++axis)
+    {
+        // Newton's divided differences allow for non-uniform sample times.
+        double d12 = (p2[axis] - p1[axis]) / (t2 - t1);
+        double value = p2[axis] + d12 * (t - t2);
+
+        if (n == 3)
+        {
+            double t0 = double(samples[0].timestampMicros);
+            glm::vec2 p0 = samples[0].position();
+            double d01 = (p1[axis] - p0[axis]) / (t1 - t0);
+            double d012 = (d12 - d01) / (t2 - t0);
+            value += d012 * (t - t2) * (t - t1);
+        }
+
+        position[axis] = value;
+    }
+
+    return true;
+}
+
+
+void QuadraticPointerPredictor::reset(std::size_t pointerId)
+{
+    _samples.erase(pointerId);
+}
+
+
+void QuadraticPointerPredictor::clear()
+{
+    _samples.clear();
+}
+
+
+void QuadraticPointerPredictor::_add(std::size_t pointerId, const PointerSample& sample)
+{
+    auto& samples = _samples[pointerId];
+
+    // Samples without elapsed time can't contribute to a derivative.
+    if (!samples.empty() && sample.timestampMicros <= samples.back().timestampMicros)
+    {
+        samples.back() = sample;
+        return;
+    }
+
+    if (samples.size() == 3)
+        samples.erase(samples.begin());
+
+    samples.push_back(sample);
+}
+
+
+KalmanPointerPredictor::KalmanPointerPredictor(std::size_t numPredictions,
+                                               uint64_t horizonMicros,
+                                               double processNoise,
+                                               double measurementNoise):
+    PointerPredictor(numPredictions, horizonMicros),
+    _processNoise(processNoise),
+    _measurementNoise(measurementNoise)
+{
+}
+
+
+KalmanPointerPredictor::~KalmanPointerPredictor()
+{
+}
+
+
+bool KalmanPointerPredictor::predictPosition(std::size_t pointerId,
+                                             uint64_t timestampMicros,
+                                             glm::vec2& position) const
+{
+    auto iter = _states.find(pointerId);
+
+    if (iter == _states.end() || iter->second.count < 2)
+        return false;
+
+    const State& state = iter->second;
+
+    double dt = (double(timestampMicros) - double(state.timestampMicros)) / 1000000.0;
+
+    position.x = state.position[0] + state.velocity[0] * dt;
+    position.y = state.position[1] + state.velocity[1] * dt;
+
+    return true;
+}
+
+
+void KalmanPointerPredictor::reset(std::size_t pointerId)
+{
+    _states.erase(pointerId);
+}
+
+
+void KalmanPointerPredictor::clear()
+{
+    _states.clear();
+}
+
+
+void KalmanPointerPredictor::_add(std::size_t pointerId, const PointerSample& sample)
+{
+    State& state = _states[pointerId];
+
+    glm::vec2 z = sample.position();
+
+    if (state.count == 0)
+    {
+        state.timestampMicros = sample.timestampMicros;
+        state.count = 1;
+        state.position = {{ z.x, z.y }};
+        state.velocity = {{ 0, 0 }};
+        // The initial velocity is unknown.
+        state.covariance = {{ _measurementNoise, 0, 1000000 }};
+        return;
+    }
+
+    auto& p = state.covariance;
+
+    // Predict.
+    if (sample.timestampMicros > state.timestampMicros)
+    {
+        double dt = double(sample.timestampMicros - state.timestampMicros) / 1000000.0;
+        double dt2 = dt * dt;
+
+        for (int axis = 0; axis < 2; ++axis)
+            state.position[axis] += state.velocity[axis] * dt;
+
+        double p00 = p[0] + 2 * dt * p[1] + dt2 * p[2] + _processNoise * dt2 * dt2 / 4;
+        double p01 = p[1] + dt * p[2] + _processNoise * dt2 * dt / 2;
+        double p11 = p[2] + _processNoise * dt2;
+
+        p = {{ p00, p01, p11 }};
+
+        state.timestampMicros = sample.timestampMicros;
+    }
+
+    // Update.
+    double s = p[0] + _measurementNoise;
+    double k0 = p[0] / s;
+    double k1 = p[1] / s;
+
+    for (int axis = 0; axis < 2; ++axis)
+    {
+        double residual = z[axis] - state.position[axis];
+        state.position[axis] += k0 * residual;
+        state.velocity[axis] += k1 * residual;
+    }
+
+    p = {{ (1 - k0) * p[0], (1 - k0) * p[1], p[2] - k1 * p[1] }};
+
+    ++state.count;
+}
+
+
+PointerPredictionError measurePredictionError(PointerPredictor& predictor,
+                                              const PointerStroke& stroke,
+                                              uint64_t horizonMicros)
+{
+    PointerPredictionError error;
+
+    std::vector<const PointerEventArgs*> measured;
+
+    for (const auto& event: stroke.events())
+    {
+        if (!event.isPredicted())
+            measured.push_back(&event);
+    }
+
+    predictor.reset(stroke.pointerId());
+
+    double sum = 0;
+    double sumSquared = 0;
+
+    std::size_t j = 0;
+
+    for (const auto* event: measured)
+    {
+        predictor.add(*event);
+
+        uint64_t targetMicros = event->timestampMicros() + horizonMicros;
+
+        // Find the recorded samples surrounding the target time.
+        while (j < measured.size() && measured[j]->timestampMicros() < targetMicros)
+            ++j;
+
+        if (j == 0 || j == measured.size())
+            continue;
+
+        glm::vec2 predicted;
+
+        if (!predictor.predictPosition(stroke.pointerId(), targetMicros, predicted))
+            continue;
+
+        const auto* a = measured[j - 1];
+        const auto* b = measured[j];
+
+        double span = double(b->timestampMicros() - a->timestampMicros());
+        float amount = span > 0 ? float((targetMicros - a->timestampMicros()) / span) : 1;
+
+        glm::vec2 actual = glm::mix(a->position(), b->position(), amount);
+
+        double distance = glm::distance(predicted, actual);
+
+        sum += distance;
+        sumSquared += distance * distance;
+        error.max = std::max(error.max, distance);
+        ++error.count;
+    }
+
+    predictor.reset(stroke.pointerId());
+
+    if (error.count > 0)
+    {
+        error.mean = sum / error.count;
+        error.rms = std::sqrt(sumSquared / error.count);
+    }
+
+    return error;
+}
+
+
+} // namespace ofx
@@ -0,0 +1,2895 @@
+//
+// Copyright (c) 2009 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#include "ofx/PointerRecording.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+
+#if defined(TARGET_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace ofx {
+namespace {
+
+
+/// \brief Record flags.
+enum RecordFlags: uint8_t
+{
+    RECORD_KEYFRAME = 1 << 0
+};
+
+
+/// \brief The optional event fields present in a record.
+enum EventFields: uint32_t
+{
+    EVENT_DETAIL = 1 << 0,
+    EVENT_DEVICE_ID = 1 << 1,
+    EVENT_POINTER_INDEX = 1 << 2,
+    EVENT_SEQUENCE_INDEX = 1 << 3,
+    EVENT_IS_COALESCED = 1 << 4,
+    EVENT_IS_PREDICTED = 1 << 5,
+    EVENT_IS_PRIMARY = 1 << 6,
+    EVENT_BUTTON = 1 << 7,
+    EVENT_BUTTONS = 1 << 8,
+    EVENT_MODIFIERS = 1 << 9,
+    EVENT_ESTIMATED_PROPERTIES = 1 << 10,
+    EVENT_ESTIMATED_PROPERTIES_EXPECTING_UPDATES = 1 << 11,
+    EVENT_COALESCED_SAMPLES = 1 << 12,
+    EVENT_PREDICTED_SAMPLES = 1 << 13
+};
+
+
+/// \brief The optional sample fields present in a record.
+enum SampleFields: uint8_t
+{
+    SAMPLE_TIMESTAMP = 1 << 0,
+    SAMPLE_SEQUENCE_INDEX = 1 << 1,
+    SAMPLE_FLAGS = 1 << 2,
+    SAMPLE_ESTIMATED_PROPERTIES = 1 << 3,
+    SAMPLE_ESTIMATED_PROPERTIES_EXPECTING_UPDATES = 1 << 4
+};
+
+
+/// \brief The optional Point fields present in a record.
+enum PointFields: uint8_t
+{
+    POINT_PRECISE_POSITION = 1 << 0,
+    POINT_SHAPE = 1 << 1,
+    POINT_PRESSURE = 1 << 2,
+    POINT_TANGENTIAL_PRESSURE = 1 << 3,
+    POINT_TWIST = 1 << 4,
+    POINT_TILT_X = 1 << 5,
+    POINT_TILT_Y = 1 << 6
+};
+
+
+} // namespace
+
+
+static void writeVarint(std::vector<uint8_t>& buffer, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        buffer.push_back(uint8_t(value | 0x80));
+        value >>= 7;
+    }
+
+    buffer.push_back(uint8_t(value));
+}
+
+
+static bool readVarint(const uint8_t*& data, const uint8_t* end, uint64_t& value)
+{
+    value = 0;
+
+    for (int shift = 0; shift < 64 && data < end; shift += 7)
+    {
+        uint8_t byte = *data++;
+        value |= uint64_t(byte & 0x7F) << shift;
+
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+
+static void writeSigned(std::vector<uint8_t>& buffer, int64_t value)
+{
+    // Zigzag encoding keeps small negative values small.
+    writeVarint(buffer, (uint64_t(value) << 1) ^ uint64_t(value >> 63));
+}
+
+
+static bool readSigned(const uint8_t*& data, const uint8_t* end, int64_t& value)
+{
+    uint64_t encoded = 0;
+
+    if (!readVarint(data, end, encoded))
+        return false;
+
+    value = int64_t(encoded >> 1) ^ -int64_t(encoded & 1);
+    return true;
+}
+
+
+static void writeByte(std::vector<uint8_t>& buffer, uint8_t value)
+{
+    buffer.push_back(value);
+}
+
+
+static bool readByte(const uint8_t*& data, const uint8_t* end, uint8_t& value)
+{
+    if (data >= end)
+        return false;
+
+    value = *data++;
+    return true;
+}
+
+
+static void writeFixed(std::vector<uint8_t>& buffer, uint64_t value, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; ++i)
+        buffer.push_back(uint8_t(value >> (8 * i)));
+}
+
+
+static uint64_t readFixed(const uint8_t* data, std::size_t size)
+{
+    uint64_t value = 0;
+
+    for (std::size_t i = 0; i < size; ++i)
+        value |= uint64_t(data[i]) << (8 * i);
+
+    return value;
+}
+
+
+static void writeFloat(std::vector<uint8_t>& buffer, float value)
+{
+    uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeFixed(buffer, bits, sizeof(bits));
+}
+
+
+static bool readFloat(const uint8_t*& data, const uint8_t* end, float& value)
+{
+    if (end - data < 4)
+        return false;
+
+    uint32_t bits = uint32_t(readFixed(data, 4));
+    std::memcpy(&value, &bits, sizeof(value));
+    data += 4;
+    return true;
+}
+
+
+static void writeString(std::vector<uint8_t>& buffer, const std::string& value)
+{
+    writeVarint(buffer, value.size());
+    buffer.insert(buffer.end(), value.begin(), value.end());
+}
+
+
+static bool readString(const uint8_t*& data, const uint8_t* end, std::string& value)
+{
+    uint64_t size = 0;
+
+    if (!readVarint(data, end, size) || uint64_t(end - data) < size)
+        return false;
+
+    value.assign(reinterpret_cast<const char*>(data), std::size_t(size));
+    data += size;
+    return true;
+}
+
+
+static int64_t quantize(float value, uint32_t scale)
+{
+    return int64_t(std::llround(double(value) * scale));
+}
+
+
+/// \brief Write a position relative to a quantized reference position.
+static void writePosition(std::vector<uint8_t>& buffer,
+                          const glm::vec2& position,
+                          uint32_t scale,
+                          std::array<int64_t, 2>& reference)
+{
+    if (scale == 0)
+    {
+        writeFloat(buffer, position.x);
+        writeFloat(buffer, position.y);
+        return;
+    }
+
+    for (int axis = 0; axis < 2; ++axis)
+    {
+        int64_t value = quantize(position[axis], scale);
+        writeSigned(buffer, value - reference[axis]);
+        reference[axis] = value;
+    }
+}
+
+
+static bool readPosition(const uint8_t*& data,
+                         const uint8_t* end,
+                         glm::vec2& position,
+                         uint32_t scale,
+                         std::array<int64_t, 2>& reference)
+{
+    if (scale == 0)
+        return readFloat(data, end, position.x) && readFloat(data, end, position.y);
+
+    for (int axis = 0; axis < 2; ++axis)
+    {
+        int64_t delta = 0;
+
+        if (!readSigned(data, end, delta))
+            return false;
+
+        reference[axis] += delta;
+        position[axis] = float(double(reference[axis]) / scale);
+    }
+
+    return true;
+}
+
+
+static bool isDefaultShape(const PointShape& shape)
+{
+    return shape.shapeType() == PointShape::ShapeType::ELLIPSE
+        && shape.width() == 1
+        && shape.height() == 1
+        && shape.widthTolerance() == 0
+        && shape.heightTolerance() == 0
+        && shape.angleDeg() == 0;
+}
+
+
+/// \brief Write a Point with its position relative to a quantized reference position.
+static void writePoint(std::vector<uint8_t>& buffer,
+                       const Point& point,
+                       uint32_t scale,
+                       std::array<int64_t, 2>& reference)
+{
+    uint8_t fields = 0;
+
+    glm::vec2 position = point.position();
+    glm::vec2 precisePosition = point.precisePosition();
+
+    if (precisePosition != position)
+        fields |= POINT_PRECISE_POSITION;
+
+    if (!isDefaultShape(point.shape()))
+        fields |= POINT_SHAPE;
+
+    if (point.pressure() != 0)
+        fields |= POINT_PRESSURE;
+
+    if (point.tangentialPressure() != 0)
+        fields |= POINT_TANGENTIAL_PRESSURE;
+
+    if (point.twistDeg() != 0)
+        fields |= POINT_TWIST;
+
+    if (point.tiltXDeg() != 0)
+        fields |= POINT_TILT_X;
+
+    if (point.tiltYDeg() != 0)
+        fields |= POINT_TILT_Y;
+
+    writeByte(buffer, fields);
+    writePosition(buffer, position, scale, reference);
+
+    if (fields & POINT_PRECISE_POSITION)
+    {
+        // The precise position is relative to the position.
+        std::array<int64_t, 2> positionReference = reference;
+        writePosition(buffer, precisePosition, scale, positionReference);
+    }
+
+    if (fields & POINT_SHAPE)
+    {
+        const PointShape& shape = point.shape();
+        writeByte(buffer, uint8_t(shape.shapeType()));
+        writeFloat(buffer, shape.width());
+        writeFloat(buffer, shape.height());
+        writeFloat(buffer, shape.widthTolerance());
+        writeFloat(buffer, shape.heightTolerance());
+        writeFloat(buffer, shape.angleDeg());
+    }
+
+    if (fields & POINT_PRESSURE)
+        writeFloat(buffer, point.pressure());
+
+    if (fields & POINT_TANGENTIAL_PRESSURE)
+        writeFloat(buffer, point.tangentialPressure());
+
+    if (fields & POINT_TWIST)
+        writeFloat(buffer, point.twistDeg());
+
+    if (fields & POINT_TILT_X)
+        writeFloat(buffer, point.tiltXDeg());
+
+    if (fields & POINT_TILT_Y)
+        writeFloat(buffer, point.tiltYDeg());
+}
+
+
+static bool readPoint(const uint8_t*& data,
+                      const uint8_t* end,
+                      Point& point,
+                      uint32_t scale,
+                      std::array<int64_t, 2>& reference)
+{
+    uint8_t fields = 0;
+
+    glm::vec2 position;
+
+    if (!readByte(data, end, fields) || !readPosition(data, end, position, scale, reference))
+        return false;
+
+    glm::vec2 precisePosition = position;
+
+    if (fields & POINT_PRECISE_POSITION)
+    {
+        std::array<int64_t, 2> positionReference = reference;
+
+        if (!readPosition(data, end, precisePosition, scale, positionReference))
+            return false;
+    }
+
+    PointShape shape;
+
+    if (fields & POINT_SHAPE)
+    {
+        uint8_t shapeType = 0;
+        float width = 1;
+        float height = 1;
+        float widthTolerance = 0;
+        float heightTolerance = 0;
+        float angleDeg = 0;
+
+        if (!readByte(data, end, shapeType)
+         || !readFloat(data, end, width)
+         || !readFloat(data, end, height)
+         || !readFloat(data, end, widthTolerance)
+         || !readFloat(data, end, heightTolerance)
+         || !readFloat(data, end, angleDeg))
+            return false;
+
+        shape = PointShape(PointShape::ShapeType(shapeType),
+                           width,
+                           height,
+                           widthTolerance,
+                           heightTolerance,
+                           angleDeg);
+    }
+
+    float pressure = 0;
+    float tangentialPressure = 0;
+    float twistDeg = 0;
+    float tiltXDeg = 0;
+    float tiltYDeg = 0;
+
+    if ((fields & POINT_PRESSURE) && !readFloat(data, end, pressure))
+        return false;
+
+    if ((fields & POINT_TANGENTIAL_PRESSURE) && !readFloat(data, end, tangentialPressure))
+        return false;
+
+    if ((fields & POINT_TWIST) && !readFloat(data, end, twistDeg))
+        return false;
+
+    if ((fields & POINT_TILT_X) && !readFloat(data, end, tiltXDeg))
+        return false;
+
+    if ((fields & POINT_TILT_Y) && !readFloat(data, end, tiltYDeg))
+        return false;
+
+    point = Point(position,
+                  precisePosition,
+                  shape,
+                  pressure,
+                  tangentialPressure,
+                  twistDeg,
+                  tiltXDeg,
+                  tiltYDeg);
+
+    return true;
+}
+
+
+/// \brief Write samples with timestamps and positions relative to the previous sample.
+static void writeSamples(std::vector<uint8_t>& buffer,
+                         Span<PointerSample> samples,
+                         const PointerEventArgs& e,
+                         uint32_t scale,
+                         std::array<int64_t, 2> reference)
+{
+    writeVarint(buffer, samples.size());
+
+    uint64_t timestampMicros = e.timestampMicros();
+
+    for (const auto& sample: samples)
+    {
+        uint8_t fields = 0;
+
+        if (sample.timestampMicros != timestampMicros)
+            fields |= SAMPLE_TIMESTAMP;
+
+        if (sample.sequenceIndex != 0)
+            fields |= SAMPLE_SEQUENCE_INDEX;
+
+        if (sample.flags != PointerSample::FLAG_NONE)
+            fields |= SAMPLE_FLAGS;
+
+        if (sample.estimatedProperties != POINTER_PROPERTY_NONE)
+            fields |= SAMPLE_ESTIMATED_PROPERTIES;
+
+        if (sample.estimatedPropertiesExpectingUpdates != POINTER_PROPERTY_NONE)
+            fields |= SAMPLE_ESTIMATED_PROPERTIES_EXPECTING_UPDATES;
+
+        writeByte(buffer, fields);
+
+        if (fields & SAMPLE_TIMESTAMP)
+            writeSigned(buffer, int64_t(sample.timestampMicros - timestampMicros));
+
+        if (fields & SAMPLE_SEQUENCE_INDEX)
+            writeSigned(buffer, int64_t(sample.sequenceIndex - e.sequenceIndex()));
+
+        if (fields & SAMPLE_FLAGS)
+            writeByte(buffer, sample.flags);
+
+        if (fields & SAMPLE_ESTIMATED_PROPERTIES)
+            writeByte(buffer, sample.estimatedProperties);
+
+        if (fields & SAMPLE_ESTIMATED_PROPERTIES_EXPECTING_UPDATES)
+            writeByte(buffer, sample.estimatedPropertiesExpectingUpdates);
+
+        writePoint(buffer, sample.point, scale, reference);
+
+        timestampMicros = sample.timestampMicros;
+    }
+}
+
+
+static bool readSamples(const uint8_t*& data,
+                        const uint8_t* end,
+                        PointerSampleBuffer& samples,
+                        uint64_t eventTimestampMicros,
+                        uint64_t eventSequenceIndex,
+                        uint32_t scale,
+                        std::array<int64_t, 2> reference)
+{
+    uint64_t size = 0;
+
+    // Each sample is at least two bytes.
+    if (!readVarint(data, end, size) || size > uint64_t(end - data) / 2)
+        return false;
+
+    uint64_t timestampMicros = eventTimestampMicros;
+
+    for (uint64_t i = 0; i < size; ++i)
+    {
+        PointerSample sample;
+        uint8_t fields = 0;
+
+        if (!readByte(data, end, fields))
+            return false;
+
+        if (fields & SAMPLE_TIMESTAMP)
+        {
+            int64_t delta = 0;
+
+            if (!readSigned(data, end, delta))
+                return false;
+
+            timestampMicros += delta;
+        }
+
+        sample.timestampMicros = timestampMicros;
+
+        if (fields & SAMPLE_SEQUENCE_INDEX)
+        {
+            int64_t delta = 0;
+
+            if (!readSigned(data, end, delta))
+                return false;
+
+            sample.sequenceIndex = eventSequenceIndex + delta;
+        }
+
+        if ((fields & SAMPLE_FLAGS) && !readByte(data, end, sample.flags))
+            return false;
+
+        if ((fields & SAMPLE_ESTIMATED_PROPERTIES) && !readByte(data, end, sample.estimatedProperties))
+            return false;
+
+        if ((fields & SAMPLE_ESTIMATED_PROPERTIES_EXPECTING_UPDATES) && !readByte(data, end, sample.estimatedPropertiesExpectingUpdates))
+            return false;
+
+        if (!readPoint(data, end, sample.point, scale, reference))
+            return false;
+
+        samples.push_back(sample);
+    }
+
+    return true;
+}
+
+
+const std::array<uint8_t, 4> PointerRecordingFormat::MAGIC = {{ 'O', 'F', 'X', 'P' }};
+constexpr uint16_t PointerRecordingFormat::VERSION;
+constexpr std::size_t PointerRecordingFormat::HEADER_SIZE;
+constexpr std::size_t PointerRecordingFormat::MAX_RECORD_SIZE;
+
+
+PointerEventEncoder::PointerEventEncoder(const PointerRecordingFormat& format):
+    _format(format)
+{
+}
+
+
+PointerEventEncoder::~PointerEventEncoder()
+{
+}
+
+
+void PointerEventEncoder::encodeHeader(std::vector<uint8_t>& buffer) const
+{
+    buffer.insert(buffer.end(),
+                  PointerRecordingFormat::MAGIC.begin(),
+                  PointerRecordingFormat::MAGIC.end());
+    writeFixed(buffer, PointerRecordingFormat::VERSION, 2);
+    writeFixed(buffer, PointerRecordingFormat::HEADER_SIZE, 2);
+    writeFixed(buffer, _format.positionScale, 4);
+    writeFixed(buffer, _format.keyframeInterval, 4);
+}
+
+
+bool PointerEventEncoder::encode(const PointerEventArgs& e, std::vector<uint8_t>& buffer)
+{
+    bool isKeyframe = _needsKeyframe
+                   || (_format.keyframeInterval > 0 && _numRecordsSinceKeyframe >= _format.keyframeInterval);
+
+    if (isKeyframe)
+    {
+        _needsKeyframe = false;
+        _numRecordsSinceKeyframe = 0;
+        _timestampMicros = 0;
+        _sequenceIndex = 0;
+        _pointers.clear();
+        _pointerIndices.clear();
+    }
+
+    uint32_t fields = 0;
+
+    if (e.detail() != 0)
+        fields |= EVENT_DETAIL;
+
+    if (e.deviceId() != 0)
+        fields |= EVENT_DEVICE_ID;
+
+    if (e.pointerIndex() != 0)
+        fields |= EVENT_POINTER_INDEX;
+
+    if (e.sequenceIndex() != 0)
+        fields |= EVENT_SEQUENCE_INDEX;
+
+    if (e.isCoalesced())
+        fields |= EVENT_IS_COALESCED;
+
+    if (e.isPredicted())
+        fields |= EVENT_IS_PREDICTED;
+
+    if (e.isPrimary())
+        fields |= EVENT_IS_PRIMARY;
+
+    if (e.button() != 0)
+        fields |= EVENT_BUTTON;
+
+    if (e.buttons() != 0)
+        fields |= EVENT_BUTTONS;
+
+    if (e.modifiers() != 0)
+        fields |= EVENT_MODIFIERS;
+
+    if (e.estimatedProperties() != POINTER_PROPERTY_NONE)
+        fields |= EVENT_ESTIMATED_PROPERTIES;
+
+    if (e.estimatedPropertiesExpectingUpdates() != POINTER_PROPERTY_NONE)
+        fields |= EVENT_ESTIMATED_PROPERTIES_EXPECTING_UPDATES;
+
+    if (!e.coalescedPointerEvents().empty())
+        fields |= EVENT_COALESCED_SAMPLES;
+
+    if (!e.predictedPointerEvents().empty())
+        fields |= EVENT_PREDICTED_SAMPLES;
+
+    _record.clear();
+
+    writeByte(_record, isKeyframe ? RECORD_KEYFRAME : 0);
+    writeVarint(_record, fields);
+
+    writeByte(_record, uint8_t(e.pointerEventType()));
+
+    if (e.pointerEventType() == PointerEventType::UNKNOWN)
+        writeString(_record, e.eventType());
+
+    if (isKeyframe)
+        writeVarint(_record, e.timestampMicros());
+    else
+        writeSigned(_record, int64_t(e.timestampMicros() - _timestampMicros));
+
+    _timestampMicros = e.timestampMicros();
+
+    // Pointers are written in full once per keyframe and then referenced.
+    auto iter = _pointerIndices.find(e.pointerId());
+
+    if (iter == _pointerIndices.end())
+    {
+        writeVarint(_record, 0);
+        writeVarint(_record, e.pointerId());
+
+        PointerState state;
+        state.pointerId = e.pointerId();
+
+        iter = _pointerIndices.insert(std::make_pair(e.pointerId(), _pointers.size())).first;
+        _pointers.push_back(state);
+    }
+    else
+    {
+        writeVarint(_record, iter->second + 1);
+    }
+
+    writeByte(_record, uint8_t(e.pointerDeviceType()));
+
+    if (e.pointerDeviceType() == PointerDeviceType::UNKNOWN)
+        writeString(_record, e.deviceType());
+
+    if (fields & EVENT_DETAIL)
+        writeVarint(_record, e.detail());
+
+    if (fields & EVENT_DEVICE_ID)
+        writeSigned(_record, e.deviceId());
+
+    if (fields & EVENT_POINTER_INDEX)
+        writeSigned(_record, e.pointerIndex());
+
+    if (fields & EVENT_SEQUENCE_INDEX)
+    {
+        writeSigned(_record, int64_t(e.sequenceIndex() - _sequenceIndex));
+        _sequenceIndex = e.sequenceIndex();
+    }
+
+    if (fields & EVENT_BUTTON)
+        writeSigned(_record, e.button());
+
+    if (fields & EVENT_BUTTONS)
+        writeVarint(_record, e.buttons());
+
+    if (fields & EVENT_MODIFIERS)
+        writeVarint(_record, e.modifiers());
+
+    if (fields & EVENT_ESTIMATED_PROPERTIES)
+        writeByte(_record, e.estimatedProperties());
+
+    if (fields & EVENT_ESTIMATED_PROPERTIES_EXPECTING_UPDATES)
+        writeByte(_record, e.estimatedPropertiesExpectingUpdates());
+
+    std::array<int64_t, 2>& reference = _pointers[iter->second].position;
+
+    writePoint(_record, e.point(), _format.positionScale, reference);
+
+    if (fields & EVENT_COALESCED_SAMPLES)
+        writeSamples(_record, e.coalescedPointerEvents(), e, _format.positionScale, reference);
+
+    if (fields & EVENT_PREDICTED_SAMPLES)
+        writeSamples(_record, e.predictedPointerEvents(), e, _format.positionScale, reference);
+
+    writeVarint(buffer, _record.size());
+    buffer.insert(buffer.end(), _record.begin(), _record.end());
+
+    ++_numRecordsSinceKeyframe;
+
+    return isKeyframe;
+}
+
+
+void PointerEventEncoder::reset()
+{
+    _needsKeyframe = true;
+}
+
+
+const PointerRecordingFormat& PointerEventEncoder::format() const
+{
+    return _format;
+}
+
+
+PointerEventDecoder::PointerEventDecoder()
+{
+}
+
+
+PointerEventDecoder::~PointerEventDecoder()
+{
+}
+
+
+std::size_t PointerEventDecoder::decodeHeader(const uint8_t* data, std::size_t size)
+{
+    if (size < PointerRecordingFormat::HEADER_SIZE
+    || !std::equal(PointerRecordingFormat::MAGIC.begin(), PointerRecordingFormat::MAGIC.end(), data))
+    {
+        ofLogError("PointerEventDecoder::decodeHeader") << "Not a pointer event recording.";
+        return 0;
+    }
+
+    uint16_t version = uint16_t(readFixed(data + 4, 2));
+    uint16_t headerSize = uint16_t(readFixed(data + 6, 2));
+
+    if (version > PointerRecordingFormat::VERSION)
+    {
+        ofLogError("PointerEventDecoder::decodeHeader") << "Unsupported version: " << version;
+        return 0;
+    }
+
+    if (headerSize < PointerRecordingFormat::HEADER_SIZE || headerSize > size)
+    {
+        ofLogError("PointerEventDecoder::decodeHeader") << "Invalid header size: " << headerSize;
+        return 0;
+    }
+
+    _format.positionScale = uint32_t(readFixed(data + 8, 4));
+    _format.keyframeInterval = uint32_t(readFixed(data + 12, 4));
+
+    reset();
+
+    return headerSize;
+}
+
+
+std::size_t PointerEventDecoder::decode(const uint8_t* data, std::size_t size, PointerEventArgs& e)
+{
+    std::size_t numBytes = 0;
+
+    if (!recordSize(data, size, numBytes) || numBytes > size)
+        return 0;
+
+    const uint8_t* end = data + numBytes;
+
+    // Skip the length prefix.
+    uint64_t payloadSize = 0;
+    readVarint(data, end, payloadSize);
+
+    if (!_decodePayload(data, end, e))
+    {
+        ofLogError("PointerEventDecoder::decode") << "Invalid record.";
+        reset();
+        return 0;
+    }
+
+    return numBytes;
+}
+
+
+void PointerEventDecoder::reset()
+{
+    _needsKeyframe = true;
+}
+
+
+const PointerRecordingFormat& PointerEventDecoder::format() const
+{
+    return _format;
+}
+
+
+bool PointerEventDecoder::recordSize(const uint8_t* data, std::size_t size, std::size_t& recordSize)
+{
+    const uint8_t* begin = data;
+    uint64_t payloadSize = 0;
+
+    if (!readVarint(data, begin + size, payloadSize)
+    ||  payloadSize > PointerRecordingFormat::MAX_RECORD_SIZE)
+    {
+        return false;
+    }
+
+    recordSize = std::size_t(data - begin) + std::size_t(payloadSize);
+    return true;
+}
+
+
+bool PointerEventDecoder::isKeyframe(const uint8_t* data, std::size_t size)
+{
+    const uint8_t* end = data + size;
+    uint64_t payloadSize = 0;
+
+    return readVarint(data, end, payloadSize)
+        && data < end
+        && (*data & RECORD_KEYFRAME);
+}
+
+
+bool PointerEventDecoder::_decodePayload(const uint8_t* data, const uint8_t* end, PointerEventArgs& e)
+{
+    uint8_t recordFlags = 0;
+
+    if (!readByte(data, end, recordFlags))
+        return false;
+
+    bool isKeyframe = recordFlags & RECORD_KEYFRAME;
+
+    if (isKeyframe)
+    {
+        _needsKeyframe = false;
+        _timestampMicros = 0;
+        _sequenceIndex = 0;
+        _pointers.clear();
+    }
+    else if (_needsKeyframe)
+    {
+        return false;
+    }
+
+    uint64_t fields = 0;
+    uint8_t eventType = 0;
+
+    if (!readVarint(data, end, fields)
+    ||  !readByte(data, end, eventType)
+    ||  eventType > uint8_t(PointerEventType::LOST_POINTER_CAPTURE))
+    {
+        return false;
+    }
+
+    std::string customEventType;
+
+    if (PointerEventType(eventType) == PointerEventType::UNKNOWN
+    && !readString(data, end, customEventType))
+        return false;
+
+    if (isKeyframe)
+    {
+        if (!readVarint(data, end, _timestampMicros))
+            return false;
+    }
+    else
+    {
+        int64_t delta = 0;
+
+        if (!readSigned(data, end, delta))
+            return false;
+
+        _timestampMicros += delta;
+    }
+
+    uint64_t pointerReference = 0;
+
+    if (!readVarint(data, end, pointerReference))
+        return false;
+
+    if (pointerReference == 0)
+    {
+        PointerState state;
+        uint64_t pointerId = 0;
+
+        if (!readVarint(data, end, pointerId))
+            return false;
+
+        state.pointerId = std::size_t(pointerId);
+        _pointers.push_back(state);
+        pointerReference = _pointers.size();
+    }
+    else if (pointerReference > _pointers.size())
+    {
+        return false;
+    }
+
+    PointerState& pointer = _pointers[pointerReference - 1];
+
+    uint8_t deviceType = 0;
+
+    if (!readByte(data, end, deviceType) || deviceType > uint8_t(PointerDeviceType::TOUCH))
+        return false;
+
+    std::string customDeviceType;
+
+    if (PointerDeviceType(deviceType) == PointerDeviceType::UNKNOWN
+    && !readString(data, end, customDeviceType))
+        return false;
+
+    uint64_t detail = 0;
+    int64_t deviceId = 0;
+    int64_t pointerIndex = 0;
+    uint64_t sequenceIndex = 0;
+    int64_t button = 0;
+    uint64_t buttons = 0;
+    uint64_t modifiers = 0;
+    uint8_t estimatedProperties = POINTER_PROPERTY_NONE;
+    uint8_t estimatedPropertiesExpectingUpdates = POINTER_PROPERTY_NONE;
+
+    if ((fields & EVENT_DETAIL) && !readVarint(data, end, detail))
+        return false;
+
+    if ((fields & EVENT_DEVICE_ID) && !readSigned(data, end, deviceId))
+        return false;
+
+    if ((fields & EVENT_POINTER_INDEX) && !readSigned(data, end, pointerIndex))
+        return false;
+
+    if (fields & EVENT_SEQUENCE_INDEX)
+    {
+        int64_t delta = 0;
+
+        if (!readSigned(data, end, delta))
+            return false;
+
+        _sequenceIndex += delta;
+        sequenceIndex = _sequenceIndex;
+    }
+
+    if ((fields & EVENT_BUTTON) && !readSigned(data, end, button))
+        return false;
+
+    if ((fields & EVENT_BUTTONS) && !readVarint(data, end, buttons))
+        return false;
+
+    if ((fields & EVENT_MODIFIERS) && !readVarint(data, end, modifiers))
+        return false;
+
+    if ((fields & EVENT_ESTIMATED_PROPERTIES) && !readByte(data, end, estimatedProperties))
+        return false;
+
+    if ((fields & EVENT_ESTIMATED_PROPERTIES_EXPECTING_UPDATES) && !readByte(data, end, estimatedPropertiesExpectingUpdates))
+        return false;
+
+    Point point;
+
+    if (!readPoint(data, end, point, _format.positionScale, pointer.position))
+        return false;
+
+    PointerSampleBuffer coalesced;
+    PointerSampleBuffer predicted;
+
+    if ((fields & EVENT_COALESCED_SAMPLES)
+    && !readSamples(data, end, coalesced, _timestampMicros, sequenceIndex, _format.positionScale, pointer.position))
+        return false;
+
+    if ((fields & EVENT_PREDICTED_SAMPLES)
+    && !readSamples(data, end, predicted, _timestampMicros, sequenceIndex, _format.positionScale, pointer.position))
+        return false;
+
+    const std::string& eventTypeName = PointerEventType(eventType) == PointerEventType::UNKNOWN
+                                     ? customEventType
+                                     : to_string(PointerEventType(eventType));
+
+    const std::string& deviceTypeName = PointerDeviceType(deviceType) == PointerDeviceType::UNKNOWN
+                                      ? customDeviceType
+                                      : to_string(PointerDeviceType(deviceType));
+
+    e = PointerEventArgs::toPointerEventArgs(nullptr,
+                                             eventTypeName,
+                                             _timestampMicros,
+                                             detail,
+                                             point,
+                                             pointer.pointerId,
+                                             deviceId,
+                                             pointerIndex,
+                                             sequenceIndex,
+                                             deviceTypeName,
+                                             fields & EVENT_IS_COALESCED,
+                                             fields & EVENT_IS_PREDICTED,
+                                             fields & EVENT_IS_PRIMARY,
+                                             int16_t(button),
+                                             uint16_t(buttons),
+                                             uint16_t(modifiers),
+                                             coalesced.samples(),
+                                             predicted.samples(),
+                                             estimatedProperties,
+                                             estimatedPropertiesExpectingUpdates);
+
+    return true;
+}
+
+
+PointerEventWriter::PointerEventWriter(std::ostream& stream,
+                                       const PointerRecordingFormat& format):
+    _stream(stream),
+    _encoder(format)
+{
+    _encoder.encodeHeader(_buffer);
+    _stream.write(reinterpret_cast<const char*>(_buffer.data()), _buffer.size());
+    _buffer.clear();
+}
+
+
+PointerEventWriter::~PointerEventWriter()
+{
+}
+
+
+bool PointerEventWriter::write(const PointerEventArgs& e)
+{
+    _encoder.encode(e, _buffer);
+    _stream.write(reinterpret_cast<const char*>(_buffer.data()), _buffer.size());
+    _buffer.clear();
+    ++_numEvents;
+    return _stream.good();
+}
+
+
+std::size_t PointerEventWriter::numEvents() const
+{
+    return _numEvents;
+}
+
+
+PointerEventReader::PointerEventReader(std::istream& stream):
+    _stream(stream)
+{
+    _record.resize(PointerRecordingFormat::HEADER_SIZE);
+
+    if (!_stream.read(reinterpret_cast<char*>(_record.data()), _record.size()))
+    {
+        ofLogError("PointerEventReader::PointerEventReader") << "Unable to read header.";
+        return;
+    }
+
+    // Newer versions may have a larger header.
+    std::size_t headerSize = std::size_t(readFixed(_record.data() + 6, 2));
+
+    if (headerSize > _record.size())
+    {
+        _record.resize(headerSize);
+        _stream.read(reinterpret_cast<char*>(_record.data()) + PointerRecordingFormat::HEADER_SIZE,
+                     headerSize - PointerRecordingFormat::HEADER_SIZE);
+    }
+
+    _isValid = _stream.good() && _decoder.decodeHeader(_record.data(), _record.size()) > 0;
+}
+
+
+PointerEventReader::~PointerEventReader()
+{
+}
+
+
+bool PointerEventReader::isValid() const
+{
+    return _isValid;
+}
+
+
+bool PointerEventReader::read(PointerEventArgs& e)
+{
+    if (!_isValid)
+        return false;
+
+    _record.clear();
+
+    std::size_t recordSize = 0;
+
+    // Read the length prefix one byte at a time.
+    do
+    {
+        char byte = 0;
+
+        if (!_stream.get(byte))
+            return false;
+
+        if (_record.size() == 10)
+        {
+            ofLogError("PointerEventReader::read") << "Invalid record size.";
+            return false;
+        }
+
+        _record.push_back(uint8_t(byte));
+    }
+    while (_record.back() & 0x80);
+
+    if (!PointerEventDecoder::recordSize(_record.data(), _record.size(), recordSize))
+    {
+        ofLogError("PointerEventReader::read") << "Invalid record size.";
+        return false;
+    }
+
+    std::size_t prefixSize = _record.size();
+    _record.resize(recordSize);
+
+    if (!_stream.read(reinterpret_cast<char*>(_record.data()) + prefixSize, recordSize - prefixSize))
+    {
+        ofLogError("PointerEventReader::read") << "Incomplete record.";
+        return false;
+    }
+
+    return _decoder.decode(_record.data(), _record.size(), e) > 0;
+}
+
+
+const PointerRecordingFormat& PointerEventReader::format() const
+{
+    return _decoder.format();
+}
+
+
+const std::string PointerRecordingFile::INDEX_EXTENSION = ".index";
+
+
+/// \brief The magic bytes at the start of a recording index.
+static const std::array<uint8_t, 4> INDEX_MAGIC = {{ 'O', 'F', 'X', 'I' }};
+
+
+/// \brief The current recording index version.
+static const uint16_t INDEX_VERSION = 2;
+
+
+/// \brief The size of the recording index header in bytes.
+static const std::size_t INDEX_HEADER_SIZE = 22;
+
+
+/// \brief The number of bytes at each end of a recording used to fingerprint it.
+static const std::size_t INDEX_FINGERPRINT_SIZE = 4096;
+
+
+/// \brief Fingerprint a recording to detect a stale index.
+///
+/// The first and last bytes of the recording are hashed with FNV-1a, which
+/// covers the header and the most recent records without reading the whole
+/// recording.
+///
+/// \param data The recording data.
+/// \param size The size of the recording in bytes.
+/// \returns the fingerprint.
+static uint64_t fingerprint(const uint8_t* data, std::size_t size)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    auto append = [&](const uint8_t* begin, const uint8_t* end)
+    {
+        for (const uint8_t* p = begin; p < end; ++p)
+        {
+            hash ^= *p;
+            hash *= 0x100000001b3ULL;
+        }
+    };
+
+    std::size_t headSize = std::min(size, INDEX_FINGERPRINT_SIZE);
+    std::size_t tailSize = std::min(size - headSize, INDEX_FINGERPRINT_SIZE);
+
+    append(data, data + headSize);
+    append(data + size - tailSize, data + size);
+
+    return hash;
+}
+
+
+PointerRecordingFile::PointerRecordingFile()
+{
+}
+
+
+PointerRecordingFile::~PointerRecordingFile()
+{
+    close();
+}
+
+
+bool PointerRecordingFile::open(const std::string& path, bool saveIndex)
+{
+    close();
+
+    std::string absolutePath = ofToDataPath(path, true);
+
+    if (!_map(absolutePath))
+    {
+        ofLogError("PointerRecordingFile::open") << "Unable to map " << path;
+        return false;
+    }
+
+    _headerSize = _decoder.decodeHeader(_data, _size);
+
+    if (_headerSize == 0)
+    {
+        ofLogError("PointerRecordingFile::open") << "Invalid recording " << path;
+        close();
+        return false;
+    }
+
+    std::string indexPath = absolutePath + INDEX_EXTENSION;
+
+    if (!_loadIndex(indexPath))
+    {
+        if (!_buildIndex())
+        {
+            ofLogError("PointerRecordingFile::open") << "Invalid recording " << path;
+            close();
+            return false;
+        }
+
+        if (saveIndex && !_saveIndex(indexPath))
+            ofLogWarning("PointerRecordingFile::open") << "Unable to save index " << indexPath;
+    }
+
+    _moveCursor(0);
+    return true;
+}
+
+
+void PointerRecordingFile::close()
+{
+    _unmap();
+    _headerSize = 0;
+    _numEvents = 0;
+    _keyframes.clear();
+    _pointerKeyframes.clear();
+    _decoder = PointerEventDecoder();
+    _cursorIndex = 0;
+    _cursorOffset = 0;
+}
+
+
+bool PointerRecordingFile::isOpen() const
+{
+    return _data != nullptr;
+}
+
+
+const PointerRecordingFormat& PointerRecordingFile::format() const
+{
+    return _decoder.format();
+}
+
+
+std::size_t PointerRecordingFile::numEvents() const
+{
+    return _numEvents;
+}
+
+
+uint64_t PointerRecordingFile::maxTimestampMicros() const
+{
+    return _keyframes.empty() ? 0 : _keyframes.back().maxTimestampMicros;
+}
+
+
+bool PointerRecordingFile::event(std::size_t index, PointerEventArgs& e) const
+{
+    if (index >= _numEvents)
+        return false;
+
+    std::size_t keyframe = _keyframeForEvent(index);
+
+    // Continue from the cursor if it is in the same block and not past the event.
+    if (_cursorIndex > index || _cursorIndex < _keyframes[keyframe].eventIndex)
+        _moveCursor(keyframe);
+
+    while (_cursorIndex <= index)
+    {
+        if (!_decodeNext(e))
+            return false;
+    }
+
+    return true;
+}
+
+
+std::size_t PointerRecordingFile::seek(uint64_t timestampMicros) const
+{
+    auto iter = std::lower_bound(_keyframes.begin(),
+                                 _keyframes.end(),
+                                 timestampMicros,
+                                 [](const Keyframe& keyframe, uint64_t timestamp) {
+                                     return keyframe.maxTimestampMicros < timestamp;
+                                 });
+
+    if (iter == _keyframes.end())
+        return _numEvents;
+
+    std::size_t keyframe = std::size_t(iter - _keyframes.begin());
+    std::size_t end = keyframe + 1 < _keyframes.size() ? std::size_t(_keyframes[keyframe + 1].eventIndex) : _numEvents;
+    uint64_t maxTimestampMicros = keyframe > 0 ? _keyframes[keyframe - 1].maxTimestampMicros : 0;
+
+    _moveCursor(keyframe);
+
+    PointerEventArgs e;
+
+    while (_cursorIndex < end)
+    {
+        std::size_t index = _cursorIndex;
+
+        if (!_decodeNext(e))
+            break;
+
+        maxTimestampMicros = std::max(maxTimestampMicros, e.timestampMicros());
+
+        if (maxTimestampMicros >= timestampMicros)
+            return index;
+    }
+
+    return end;
+}
+
+
+std::vector<std::size_t> PointerRecordingFile::pointerIds() const
+{
+    std::vector<std::size_t> ids;
+    ids.reserve(_pointerKeyframes.size());
+
+    for (const auto& entry: _pointerKeyframes)
+        ids.push_back(entry.first);
+
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+
+std::size_t PointerRecordingFile::nextEventForPointerId(std::size_t pointerId, std::size_t index) const
+{
+    auto iter = _pointerKeyframes.find(pointerId);
+
+    if (iter == _pointerKeyframes.end() || index >= _numEvents)
+        return _numEvents;
+
+    const auto& keyframes = iter->second;
+
+    PointerEventArgs e;
+
+    for (auto k = std::lower_bound(keyframes.begin(), keyframes.end(), _keyframeForEvent(index));
+         k != keyframes.end();
+         ++k)
+    {
+        std::size_t begin = std::max(index, std::size_t(_keyframes[*k].eventIndex));
+        std::size_t end = *k + 1 < _keyframes.size() ? std::size_t(_keyframes[*k + 1].eventIndex) : _numEvents;
+
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            if (!event(i, e))
+                return _numEvents;
+
+            if (e.pointerId() == pointerId)
+                return i;
+        }
+    }
+
+    return _numEvents;
+}
+
+
+std::size_t PointerRecordingFile::read(uint64_t minTimestampMicros,
+                                       uint64_t maxTimestampMicros,
+                                       PointerEventCollection& collection) const
+{
+    std::size_t count = 0;
+
+    PointerEventArgs e;
+
+    for (std::size_t i = seek(minTimestampMicros); i < _numEvents; ++i)
+    {
+        if (!event(i, e) || e.timestampMicros() > maxTimestampMicros)
+            break;
+
+        if (e.timestampMicros() >= minTimestampMicros)
+        {
+            collection.add(e);
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+
+const std::vector<PointerRecordingFile::Keyframe>& PointerRecordingFile::keyframes() const
+{
+    return _keyframes;
+}
+
+
+bool PointerRecordingFile::_map(const std::string& path)
+{
+#if defined(TARGET_WIN32)
+    HANDLE file = CreateFileA(path.c_str(),
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+
+    if (mapping == nullptr)
+        return false;
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (data == nullptr)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    _mapping = mapping;
+    _data = static_cast<const uint8_t*>(data);
+    _size = std::size_t(size.QuadPart);
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+
+    if (file < 0)
+        return false;
+
+    struct stat status;
+
+    if (fstat(file, &status) != 0 || status.st_size == 0)
+    {
+        ::close(file);
+        return false;
+    }
+
+    void* data = mmap(nullptr, std::size_t(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+
+    // The mapping remains valid after the file is closed.
+    ::close(file);
+
+    if (data == MAP_FAILED)
+        return false;
+
+    // Events are mostly read in order.
+    madvise(data, std::size_t(status.st_size), MADV_SEQUENTIAL);
+
+    _data = static_cast<const uint8_t*>(data);
+    _size = std::size_t(status.st_size);
+#endif
+
+    return true;
+}
+
+
+void PointerRecordingFile::_unmap()
+{
+    if (_data == nullptr)
+        return;
+
+#if defined(TARGET_WIN32)
+    UnmapViewOfFile(_data);
+    CloseHandle(_mapping);
+#else
+    munmap(const_cast<uint8_t*>(_data), _size);
+#endif
+
+    _data = nullptr;
+    _size = 0;
+    _mapping = nullptr;
+}
+
+
+bool PointerRecordingFile::_buildIndex()
+{
+    _numEvents = 0;
+    _keyframes.clear();
+    _pointerKeyframes.clear();
+
+    _moveCursor(0);
+
+    uint64_t maxTimestampMicros = 0;
+
+    PointerEventArgs e;
+
+    while (_cursorOffset < _size)
+    {
+        bool isKeyframe = PointerEventDecoder::isKeyframe(_data + _cursorOffset, _size - _cursorOffset);
+
+        if (_keyframes.empty() && !isKeyframe)
+            return false;
+
+        Keyframe keyframe;
+        keyframe.offset = _cursorOffset;
+        keyframe.eventIndex = _cursorIndex;
+
+        if (!_decodeNext(e))
+        {
+            ofLogWarning("PointerRecordingFile::_buildIndex") << "Ignoring " << (_size - _cursorOffset) << " bytes after event " << _numEvents << ".";
+            break;
+        }
+
+        if (isKeyframe)
+            _keyframes.push_back(keyframe);
+
+        maxTimestampMicros = std::max(maxTimestampMicros, e.timestampMicros());
+        _keyframes.back().maxTimestampMicros = maxTimestampMicros;
+
+        auto& pointerKeyframes = _pointerKeyframes[e.pointerId()];
+
+        if (pointerKeyframes.empty() || pointerKeyframes.back() != _keyframes.size() - 1)
+            pointerKeyframes.push_back(_keyframes.size() - 1);
+
+        ++_numEvents;
+    }
+
+    return true;
+}
+
+
+bool PointerRecordingFile::_loadIndex(const std::string& path)
+{
+    std::ifstream stream(path, std::ios::binary);
+
+    if (!stream)
+        return false;
+
+    std::vector<uint8_t> buffer((std::istreambuf_iterator<char>(stream)),
+                                std::istreambuf_iterator<char>());
+
+    const uint8_t* data = buffer.data();
+    const uint8_t* end = data + buffer.size();
+
+    // A recording of the same size may have been re-recorded, so the
+    // fingerprint is checked too.
+    if (buffer.size() < INDEX_HEADER_SIZE
+    || !std::equal(INDEX_MAGIC.begin(), INDEX_MAGIC.end(), data)
+    ||  readFixed(data + 4, 2) != INDEX_VERSION
+    ||  readFixed(data + 6, 8) != _size
+    ||  readFixed(data + 14, 8) != fingerprint(_data, _size))
+    {
+        return false;
+    }
+
+    data += INDEX_HEADER_SIZE;
+
+    uint64_t numEvents = 0;
+    uint64_t numKeyframes = 0;
+
+    if (!readVarint(data, end, numEvents)
+    ||  !readVarint(data, end, numKeyframes)
+    ||  numKeyframes > numEvents
+    ||  numEvents > _size)
+    {
+        return false;
+    }
+
+    std::vector<Keyframe> keyframes(numKeyframes);
+    Keyframe last;
+
+    for (auto& keyframe: keyframes)
+    {
+        uint64_t offset = 0;
+        uint64_t eventIndex = 0;
+        uint64_t timestamp = 0;
+
+        if (!readVarint(data, end, offset)
+        ||  !readVarint(data, end, eventIndex)
+        ||  !readVarint(data, end, timestamp))
+        {
+            return false;
+        }
+
+        keyframe.offset = last.offset + offset;
+        keyframe.eventIndex = last.eventIndex + eventIndex;
+        keyframe.maxTimestampMicros = last.maxTimestampMicros + timestamp;
+
+        if (keyframe.offset >= _size
+        ||  keyframe.eventIndex >= numEvents
+        ||  !PointerEventDecoder::isKeyframe(_data + keyframe.offset, _size - keyframe.offset))
+        {
+            return false;
+        }
+
+        last = keyframe;
+    }
+
+    uint64_t numPointers = 0;
+
+    if (!readVarint(data, end, numPointers))
+        return false;
+
+    std::unordered_map<std::size_t, std::vector<std::size_t>> pointerKeyframes;
+
+    for (uint64_t i = 0; i < numPointers; ++i)
+    {
+        uint64_t pointerId = 0;
+        uint64_t count = 0;
+
+        if (!readVarint(data, end, pointerId)
+        ||  !readVarint(data, end, count)
+        ||  count > numKeyframes)
+        {
+            return false;
+        }
+
+        auto& indices = pointerKeyframes[std::size_t(pointerId)];
+        indices.reserve(count);
+
+        uint64_t keyframe = 0;
+
+        for (uint64_t j = 0; j < count; ++j)
+        {
+            uint64_t delta = 0;
+
+            if (!readVarint(data, end, delta) || keyframe + delta >= numKeyframes)
+                return false;
+
+            keyframe += delta;
+            indices.push_back(std::size_t(keyframe));
+        }
+    }
+
+    if (data != end)
+        return false;
+
+    _numEvents = std::size_t(numEvents);
+    _keyframes = std::move(keyframes);
+    _pointerKeyframes = std::move(pointerKeyframes);
+
+    return true;
+}
+
+
+bool PointerRecordingFile::_saveIndex(const std::string& path) const
+{
+    std::vector<uint8_t> buffer(INDEX_MAGIC.begin(), INDEX_MAGIC.end());
+    writeFixed(buffer, INDEX_VERSION, 2);
+    writeFixed(buffer, _size, 8);
+    writeFixed(buffer, fingerprint(_data, _size), 8);
+    writeVarint(buffer, _numEvents);
+    writeVarint(buffer, _keyframes.size());
+
+    // Keyframe fields are delta coded.
+    Keyframe last;
+
+    for (const auto& keyframe: _keyframes)
+    {
+        writeVarint(buffer, keyframe.offset - last.offset);
+        writeVarint(buffer, keyframe.eventIndex - last.eventIndex);
+        writeVarint(buffer, keyframe.maxTimestampMicros - last.maxTimestampMicros);
+        last = keyframe;
+    }
+
+    writeVarint(buffer, _pointerKeyframes.size());
+
+    for (const auto& entry: _pointerKeyframes)
+    {
+        writeVarint(buffer, entry.first);
+        writeVarint(buffer, entry.second.size());
+
+        std::size_t keyframe = 0;
+
+        for (auto index: entry.second)
+        {
+            writeVarint(buffer, index - keyframe);
+            keyframe = index;
+        }
+    }
+
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    stream.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    return stream.good();
+}
+
+
+std::size_t PointerRecordingFile::_keyframeForEvent(std::size_t index) const
+{
+    auto iter = std::upper_bound(_keyframes.begin(),
+                                 _keyframes.end(),
+                                 uint64_t(index),
+                                 [](uint64_t eventIndex, const Keyframe& keyframe) {
+                                     return eventIndex < keyframe.eventIndex;
+                                 });
+
+    return iter == _keyframes.begin() ? 0 : std::size_t(iter - _keyframes.begin()) - 1;
+}
+
+
+bool PointerRecordingFile::_decodeNext(PointerEventArgs& e) const
+{
+    std::size_t numBytes = _decoder.decode(_data + _cursorOffset, _size - _cursorOffset, e);
+
+    if (numBytes == 0)
+        return false;
+
+    _cursorOffset += numBytes;
+    ++_cursorIndex;
+    return true;
+}
+
+
+void PointerRecordingFile::_moveCursor(std::size_t keyframe) const
+{
+    _decoder.reset();
+
+    if (keyframe < _keyframes.size())
+    {
+        _cursorIndex = std::size_t(_keyframes[keyframe].eventIndex);
+        _cursorOffset = std::size_t(_keyframes[keyframe].offset);
+    }
+    else
+    {
+        _cursorIndex = 0;
+        _cursorOffset = _headerSize;
+    }
+}
+
+
+constexpr std::size_t PointerEventRecorder::BUFFER_SIZE;
+
+
+PointerEventRecorder::PointerEventRecorder()
+{
+}
+
+
+PointerEventRecorder::~PointerEventRecorder()
+{
+    stop();
+}
+
+
+bool PointerEventRecorder::start(PointerEvents& events,
+                                 const std::string& path,
+                                 const PointerRecordingFormat& format)
+{
+    stop();
+
+    _stream.open(ofToDataPath(path, true), std::ios::binary | std::ios::trunc);
+
+    if (!_stream.is_open())
+    {
+        ofLogError("PointerEventRecorder::start") << "Unable to open " << path;
+        return false;
+    }
+
+    _encoder = PointerEventEncoder(format);
+    _buffer.clear();
+    _encoder.encodeHeader(_buffer);
+    _numEvents = 0;
+    _isRecording = true;
+
+    _thread = std::thread(&PointerEventRecorder::_write, this);
+
+    _pointerEventListener = events.pointerEvent.newListener(this,
+                                                            &PointerEventRecorder::onPointerEvent,
+                                                            OF_EVENT_ORDER_BEFORE_APP);
+
+    return true;
+}
+
+
+void PointerEventRecorder::stop()
+{
+    if (!_isRecording)
+        return;
+
+    _pointerEventListener.unsubscribe();
+
+    _send();
+
+    // An empty block tells the thread to finish.
+    _channel.send(std::vector<uint8_t>());
+    _thread.join();
+
+    _stream.close();
+    _isRecording = false;
+}
+
+
+bool PointerEventRecorder::isRecording() const
+{
+    return _isRecording;
+}
+
+
+std::size_t PointerEventRecorder::numEvents() const
+{
+    return _numEvents;
+}
+
+
+bool PointerEventRecorder::onPointerEvent(PointerEventArgs& e)
+{
+    _encoder.encode(e, _buffer);
+    ++_numEvents;
+
+    if (_buffer.size() >= BUFFER_SIZE)
+        _send();
+
+    return false;
+}
+
+
+void PointerEventRecorder::_send()
+{
+    if (_buffer.empty())
+        return;
+
+    std::vector<uint8_t> block;
+    block.reserve(BUFFER_SIZE + BUFFER_SIZE / 4);
+    block.swap(_buffer);
+    _channel.send(std::move(block));
+}
+
+
+void PointerEventRecorder::_write()
+{
+    std::vector<uint8_t> block;
+
+    while (_channel.receive(block) && !block.empty())
+    {
+        _stream.write(reinterpret_cast<const char*>(block.data()), block.size());
+
+        if (!_stream.good())
+            ofLogError("PointerEventRecorder::_write") << "Error writing recording.";
+    }
+
+    _stream.flush();
+}
+
+
+const double PointerEventPlayer::AS_FAST_AS_POSSIBLE = std::numeric_limits<double>::infinity();
+
+
+PointerEventPlayer::PointerEventPlayer()
+{
+}
+
+
+PointerEventPlayer::~PointerEventPlayer()
+{
+}
+
+
+bool PointerEventPlayer::load(const std::string& path)
+{
+    stop();
+
+    _position = 0;
+
+    return _file.open(path);
+}
+
+
+bool PointerEventPlayer::play(PointerEvents& events)
+{
+    stop();
+
+    if (_position >= _file.numEvents())
+        _position = 0;
+
+    _events = &events;
+    _numEvents = 0;
+    _isPlaying = _restart();
+
+    return _isPlaying;
+}
+
+
+void PointerEventPlayer::stop()
+{
+    _isPlaying = false;
+    _hasNext = false;
+    _events = nullptr;
+}
+
+
+bool PointerEventPlayer::isPlaying() const
+{
+    return _isPlaying;
+}
+
+
+void PointerEventPlayer::seek(uint64_t timestampMicros)
+{
+    _position = _file.seek(timestampMicros);
+    _hasNext = false;
+
+    if (_isPlaying)
+        _isPlaying = _restart();
+}
+
+
+std::size_t PointerEventPlayer::position() const
+{
+    return _position;
+}
+
+
+const PointerRecordingFile& PointerEventPlayer::file() const
+{
+    return _file;
+}
+
+
+std::size_t PointerEventPlayer::update()
+{
+    if (!_isPlaying)
+        return 0;
+
+    uint64_t targetMicros = std::numeric_limits<uint64_t>::max();
+
+    if (!std::isinf(_speed))
+    {
+        uint64_t elapsedMicros = PointerClock::defaultClock()->nowMicros() - _startMicros;
+        double scaledMicros = elapsedMicros * _speed;
+
+        // Very high speeds play every remaining event.
+        if (scaledMicros < double(targetMicros - _firstTimestampMicros))
+            targetMicros = _firstTimestampMicros + uint64_t(scaledMicros);
+    }
+
+    std::size_t count = 0;
+
+    while (_hasNext && _next.timestampMicros() <= targetMicros)
+    {
+        if (_clock)
+            _clock->setMicros(_next.timestampMicros());
+
+        _events->onPointerEvent(nullptr, _next);
+        ++count;
+
+        _hasNext = _file.event(++_position, _next);
+    }
+
+    // Keep the clock moving between events.
+    if (_clock && _hasNext)
+        _clock->setMicros(std::max(_clock->nowMicros(), targetMicros));
+
+    _numEvents += count;
+
+    if (!_hasNext)
+        stop();
+
+    return count;
+}
+
+
+void PointerEventPlayer::setSpeed(double speed)
+{
+    // This also rejects NaN.
+    if (!(speed > 0))
+    {
+        ofLogError("PointerEventPlayer::setSpeed") << "Invalid speed " << speed << ", the speed must be greater than 0.";
+        return;
+    }
+
+    // Keep the playback position when changing speed.
+    if (_isPlaying && !std::isinf(_speed) && !std::isinf(speed))
+    {
+        uint64_t nowMicros = PointerClock::defaultClock()->nowMicros();
+        uint64_t elapsedMicros = uint64_t((nowMicros - _startMicros) * _speed);
+        _startMicros = nowMicros - uint64_t(elapsedMicros / speed);
+    }
+
+    _speed = speed;
+}
+
+
+double PointerEventPlayer::getSpeed() const
+{
+    return _speed;
+}
+
+
+void PointerEventPlayer::setClock(std::shared_ptr<ManualPointerClock> clock)
+{
+    _clock = clock;
+}
+
+
+std::shared_ptr<ManualPointerClock> PointerEventPlayer::getClock() const
+{
+    return _clock;
+}
+
+
+std::size_t PointerEventPlayer::numEvents() const
+{
+    return _numEvents;
+}
+
+
+bool PointerEventPlayer::_restart()
+{
+    _hasNext = _file.event(_position, _next);
+    _firstTimestampMicros = _next.timestampMicros();
+    _startMicros = PointerClock::defaultClock()->nowMicros();
+    return _hasNext;
+}
+
+
+const std::array<uint8_t, 4> PointerArchiveFormat::MAGIC = {{ 'O', 'F', 'X', 'A' }};
+constexpr uint16_t PointerArchiveFormat::VERSION;
+constexpr std::size_t PointerArchiveFormat::HEADER_SIZE;
+constexpr std::size_t PointerArchiveFormat::NUM_COLUMNS;
+constexpr int64_t PointerArchiveFormat::ROW_EVENT;
+constexpr int64_t PointerArchiveFormat::ROW_COALESCED;
+constexpr int64_t PointerArchiveFormat::ROW_PREDICTED;
+
+
+/// \brief The size of the archive trailer, holding the footer size and magic bytes.
+static const std::size_t ARCHIVE_TRAILER_SIZE = 12;
+
+
+const std::string& PointerArchiveFormat::columnName(PointerArchiveColumn column)
+{
+    static const std::array<std::string, NUM_COLUMNS> NAMES =
+    {{
+        "row_type",
+        "event_type",
+        "timestamp_micros",
+        "detail",
+        "point.position.x",
+        "point.position.y",
+        "point.precise_position.x",
+        "point.precise_position.y",
+        "point.shape.shape_type",
+        "point.shape.width",
+        "point.shape.height",
+        "point.shape.width_tolerance",
+        "point.shape.height_tolerance",
+        "point.shape.angle_deg",
+        "point.pressure",
+        "point.tangential_pressure",
+        "point.twist_deg",
+        "point.tilt_x_deg",
+        "point.tilt_y_deg",
+        "pointer_id",
+        "device_id",
+        "pointer_index",
+        "sequence_index",
+        "device_type",
+        "is_coalesced",
+        "is_predicted",
+        "is_primary",
+        "button",
+        "buttons",
+        "modifiers",
+        "estimated_properties",
+        "estimated_properties_expecting_updates"
+    }};
+
+    return NAMES[std::size_t(column)];
+}
+
+
+bool PointerArchiveFormat::isFloatColumn(PointerArchiveColumn column)
+{
+    switch (column)
+    {
+        case PointerArchiveColumn::POSITION_X:
+        case PointerArchiveColumn::POSITION_Y:
+        case PointerArchiveColumn::PRECISE_POSITION_X:
+        case PointerArchiveColumn::PRECISE_POSITION_Y:
+        case PointerArchiveColumn::WIDTH:
+        case PointerArchiveColumn::HEIGHT:
+        case PointerArchiveColumn::WIDTH_TOLERANCE:
+        case PointerArchiveColumn::HEIGHT_TOLERANCE:
+        case PointerArchiveColumn::ANGLE_DEG:
+        case PointerArchiveColumn::PRESSURE:
+        case PointerArchiveColumn::TANGENTIAL_PRESSURE:
+        case PointerArchiveColumn::TWIST_DEG:
+        case PointerArchiveColumn::TILT_X_DEG:
+        case PointerArchiveColumn::TILT_Y_DEG:
+            return true;
+        default:
+            return false;
+    }
+}
+
+
+/// \returns true if the column is quantized when a position scale is set.
+static bool isPositionColumn(PointerArchiveColumn column)
+{
+    return column == PointerArchiveColumn::POSITION_X
+        || column == PointerArchiveColumn::POSITION_Y
+        || column == PointerArchiveColumn::PRECISE_POSITION_X
+        || column == PointerArchiveColumn::PRECISE_POSITION_Y;
+}
+
+
+static int64_t toBits(float value)
+{
+    uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return int64_t(bits);
+}
+
+
+static float toFloat(int64_t bits)
+{
+    uint32_t value = uint32_t(bits);
+    float result = 0;
+    std::memcpy(&result, &value, sizeof(result));
+    return result;
+}
+
+
+PointerArchiveWriter::PointerArchiveWriter(std::ostream& stream,
+                                           const PointerArchiveFormat& format):
+    _stream(stream),
+    _format(format)
+{
+    _format.chunkSize = std::max(_format.chunkSize, uint32_t(1));
+
+    for (auto& column: _columns)
+        column.reserve(_format.chunkSize + 64);
+
+    _buffer.assign(PointerArchiveFormat::MAGIC.begin(), PointerArchiveFormat::MAGIC.end());
+    writeFixed(_buffer, PointerArchiveFormat::VERSION, 2);
+    writeFixed(_buffer, PointerArchiveFormat::HEADER_SIZE, 2);
+    writeFixed(_buffer, _format.positionScale, 4);
+    writeFixed(_buffer, _format.chunkSize, 4);
+
+    _stream.write(reinterpret_cast<const char*>(_buffer.data()), _buffer.size());
+    _offset = _buffer.size();
+}
+
+
+PointerArchiveWriter::~PointerArchiveWriter()
+{
+    close();
+}
+
+
+bool PointerArchiveWriter::add(const PointerEventArgs& e)
+{
+    if (_isClosed)
+    {
+        ofLogError("PointerArchiveWriter::add") << "The archive is closed.";
+        return false;
+    }
+
+    _addRow(e, e.toPointerSample(), PointerArchiveFormat::ROW_EVENT);
+
+    for (const auto& sample: e.coalescedPointerEvents())
+        _addRow(e, sample, PointerArchiveFormat::ROW_COALESCED);
+
+    for (const auto& sample: e.predictedPointerEvents())
+        _addRow(e, sample, PointerArchiveFormat::ROW_PREDICTED);
+
+    ++_numEvents;
+
+    if (_columns[0].size() >= _format.chunkSize)
+        _writeChunk();
+
+    return _stream.good();
+}
+
+
+bool PointerArchiveWriter::close()
+{
+    if (_isClosed)
+        return _stream.good();
+
+    _writeChunk();
+
+    _buffer.clear();
+    writeVarint(_buffer, _numRows);
+    writeVarint(_buffer, _dictionary.size());
+
+    for (const auto& value: _dictionary)
+        writeString(_buffer, value);
+
+    writeVarint(_buffer, _chunkRows.size());
+
+    for (std::size_t chunk = 0; chunk < _chunkRows.size(); ++chunk)
+    {
+        const auto& columns = _chunkColumns[chunk];
+
+        writeVarint(_buffer, _chunkRows[chunk]);
+        writeVarint(_buffer, columns[0].offset);
+
+        for (std::size_t i = 0; i < PointerArchiveFormat::NUM_COLUMNS; ++i)
+        {
+            const auto& info = columns[i];
+
+            writeVarint(_buffer, info.size);
+
+            if (PointerArchiveFormat::isFloatColumn(PointerArchiveColumn(i)))
+            {
+                writeFloat(_buffer, info.stats.minFloat);
+                writeFloat(_buffer, info.stats.maxFloat);
+            }
+            else
+            {
+                writeSigned(_buffer, info.stats.minInteger);
+                writeSigned(_buffer, info.stats.maxInteger);
+            }
+        }
+    }
+
+    uint64_t footerSize = _buffer.size();
+    writeFixed(_buffer, footerSize, 8);
+    _buffer.insert(_buffer.end(), PointerArchiveFormat::MAGIC.begin(), PointerArchiveFormat::MAGIC.end());
+
+    _stream.write(reinterpret_cast<const char*>(_buffer.data()), _buffer.size());
+    _stream.flush();
+
+    _isClosed = true;
+    return _stream.good();
+}
+
+
+std::size_t PointerArchiveWriter::numEvents() const
+{
+    return _numEvents;
+}
+
+
+std::size_t PointerArchiveWriter::numRows() const
+{
+    return _numRows;
+}
+
+
+void PointerArchiveWriter::_addRow(const PointerEventArgs& e,
+                                   const PointerSample& sample,
+                                   int64_t rowType)
+{
+    const Point& point = sample.point;
+    const PointShape& shape = point.shape();
+
+    _add(PointerArchiveColumn::ROW_TYPE, rowType);
+    _add(PointerArchiveColumn::EVENT_TYPE, _dictionaryId(e.eventType()));
+    _add(PointerArchiveColumn::TIMESTAMP_MICROS, int64_t(sample.timestampMicros));
+    _add(PointerArchiveColumn::DETAIL, int64_t(e.detail()));
+    _add(PointerArchiveColumn::POSITION_X, point.position().x);
+    _add(PointerArchiveColumn::POSITION_Y, point.position().y);
+    _add(PointerArchiveColumn::PRECISE_POSITION_X, point.precisePosition().x);
+    _add(PointerArchiveColumn::PRECISE_POSITION_Y, point.precisePosition().y);
+    _add(PointerArchiveColumn::SHAPE_TYPE, int64_t(shape.shapeType()));
+    _add(PointerArchiveColumn::WIDTH, shape.width());
+    _add(PointerArchiveColumn::HEIGHT, shape.height());
+    _add(PointerArchiveColumn::WIDTH_TOLERANCE, shape.widthTolerance());
+    _add(PointerArchiveColumn::HEIGHT_TOLERANCE, shape.heightTolerance());
+    _add(PointerArchiveColumn::ANGLE_DEG, shape.angleDeg());
+    _add(PointerArchiveColumn::PRESSURE, point.pressure());
+    _add(PointerArchiveColumn::TANGENTIAL_PRESSURE, point.tangentialPressure());
+    _add(PointerArchiveColumn::TWIST_DEG, point.twistDeg());
+    _add(PointerArchiveColumn::TILT_X_DEG, point.tiltXDeg());
+    _add(PointerArchiveColumn::TILT_Y_DEG, point.tiltYDeg());
+    _add(PointerArchiveColumn::POINTER_ID, int64_t(e.pointerId()));
+    _add(PointerArchiveColumn::DEVICE_ID, e.deviceId());
+    _add(PointerArchiveColumn::POINTER_INDEX, e.pointerIndex());
+    _add(PointerArchiveColumn::SEQUENCE_INDEX, int64_t(sample.sequenceIndex));
+    _add(PointerArchiveColumn::DEVICE_TYPE, _dictionaryId(e.deviceType()));
+    _add(PointerArchiveColumn::IS_COALESCED, int64_t(sample.isCoalesced()));
+    _add(PointerArchiveColumn::IS_PREDICTED, int64_t(sample.isPredicted()));
+    _add(PointerArchiveColumn::IS_PRIMARY, int64_t(e.isPrimary()));
+    _add(PointerArchiveColumn::BUTTON, int64_t(e.button()));
+    _add(PointerArchiveColumn::BUTTONS, int64_t(e.buttons()));
+    _add(PointerArchiveColumn::MODIFIERS, int64_t(e.modifiers()));
+    _add(PointerArchiveColumn::ESTIMATED_PROPERTIES, int64_t(sample.estimatedProperties));
+    _add(PointerArchiveColumn::ESTIMATED_PROPERTIES_EXPECTING_UPDATES, int64_t(sample.estimatedPropertiesExpectingUpdates));
+
+    ++_numRows;
+}
+
+
+void PointerArchiveWriter::_add(PointerArchiveColumn column, int64_t value)
+{
+    _columns[std::size_t(column)].push_back(value);
+}
+
+
+void PointerArchiveWriter::_add(PointerArchiveColumn column, float value)
+{
+    // Store quantized positions as they will be read.
+    if (_format.positionScale > 0 && isPositionColumn(column))
+        value = float(double(quantize(value, _format.positionScale)) / _format.positionScale);
+
+    _columns[std::size_t(column)].push_back(toBits(value));
+}
+
+
+int64_t PointerArchiveWriter::_dictionaryId(const std::string& value)
+{
+    auto iter = _dictionaryIds.find(value);
+
+    if (iter != _dictionaryIds.end())
+        return iter->second;
+
+    int64_t id = int64_t(_dictionary.size());
+    _dictionary.push_back(value);
+    _dictionaryIds[value] = id;
+    return id;
+}
+
+
+void PointerArchiveWriter::_writeChunk()
+{
+    std::size_t numRows = _columns[0].size();
+
+    if (numRows == 0)
+        return;
+
+    std::array<PointerArchiveColumnInfo, PointerArchiveFormat::NUM_COLUMNS> infos;
+
+    for (std::size_t i = 0; i < PointerArchiveFormat::NUM_COLUMNS; ++i)
+    {
+        PointerArchiveColumn column = PointerArchiveColumn(i);
+        const auto& values = _columns[i];
+        auto& info = infos[i];
+
+        _buffer.clear();
+
+        if (!PointerArchiveFormat::isFloatColumn(column))
+        {
+            info.stats.minInteger = std::numeric_limits<int64_t>::max();
+            info.stats.maxInteger = std::numeric_limits<int64_t>::min();
+
+            int64_t previous = 0;
+
+            for (auto value: values)
+            {
+                info.stats.minInteger = std::min(info.stats.minInteger, value);
+                info.stats.maxInteger = std::max(info.stats.maxInteger, value);
+                writeSigned(_buffer, int64_t(uint64_t(value) - uint64_t(previous)));
+                previous = value;
+            }
+        }
+        else
+        {
+            // NaN values are not part of the range.
+            info.stats.minFloat = std::numeric_limits<float>::infinity();
+            info.stats.maxFloat = -std::numeric_limits<float>::infinity();
+
+            bool isQuantized = _format.positionScale > 0 && isPositionColumn(column);
+            int64_t previous = 0;
+
+            for (auto bits: values)
+            {
+                float value = toFloat(bits);
+
+                if (!std::isnan(value))
+                {
+                    info.stats.minFloat = std::min(info.stats.minFloat, value);
+                    info.stats.maxFloat = std::max(info.stats.maxFloat, value);
+                }
+
+                if (isQuantized)
+                {
+                    int64_t quantized = quantize(value, _format.positionScale);
+                    writeSigned(_buffer, quantized - previous);
+                    previous = quantized;
+                }
+                else
+                {
+                    // Nearby values share their sign, exponent and high mantissa bits.
+                    writeVarint(_buffer, uint64_t(bits ^ previous));
+                    previous = bits;
+                }
+            }
+        }
+
+        info.offset = _offset;
+        info.size = _buffer.size();
+
+        _stream.write(reinterpret_cast<const char*>(_buffer.data()), _buffer.size());
+        _offset += _buffer.size();
+    }
+
+    for (auto& column: _columns)
+        column.clear();
+
+    _chunkRows.push_back(numRows);
+    _chunkColumns.push_back(infos);
+}
+
+
+PointerArchiveReader::PointerArchiveReader()
+{
+}
+
+
+PointerArchiveReader::~PointerArchiveReader()
+{
+}
+
+
+bool PointerArchiveReader::open(const std::string& path)
+{
+    close();
+
+    _stream.open(ofToDataPath(path, true), std::ios::binary);
+
+    if (!_stream.is_open())
+    {
+        ofLogError("PointerArchiveReader::open") << "Unable to open " << path;
+        return false;
+    }
+
+    uint8_t header[PointerArchiveFormat::HEADER_SIZE];
+
+    if (!_stream.read(reinterpret_cast<char*>(header), sizeof(header))
+    || !std::equal(PointerArchiveFormat::MAGIC.begin(), PointerArchiveFormat::MAGIC.end(), header)
+    ||  readFixed(header + 4, 2) > PointerArchiveFormat::VERSION)
+    {
+        ofLogError("PointerArchiveReader::open") << "Invalid archive " << path;
+        close();
+        return false;
+    }
+
+    _format.positionScale = uint32_t(readFixed(header + 8, 4));
+    _format.chunkSize = uint32_t(readFixed(header + 12, 4));
+
+    _stream.seekg(0, std::ios::end);
+    uint64_t size = uint64_t(_stream.tellg());
+
+    if (!_readFooter(size))
+    {
+        ofLogError("PointerArchiveReader::open") << "Invalid archive footer " << path;
+        close();
+        return false;
+    }
+
+    _isOpen = true;
+    return true;
+}
+
+
+void PointerArchiveReader::close()
+{
+    if (_stream.is_open())
+        _stream.close();
+
+    _stream.clear();
+    _format = PointerArchiveFormat();
+    _numRows = 0;
+    _chunkRows.clear();
+    _chunkColumns.clear();
+    _dictionary.clear();
+    _numBytesRead = 0;
+    _isOpen = false;
+}
+
+
+bool PointerArchiveReader::isOpen() const
+{
+    return _isOpen;
+}
+
+
+const PointerArchiveFormat& PointerArchiveReader::format() const
+{
+    return _format;
+}
+
+
+std::size_t PointerArchiveReader::numRows() const
+{
+    return _numRows;
+}
+
+
+std::size_t PointerArchiveReader::numChunks() const
+{
+    return _chunkRows.size();
+}
+
+
+std::size_t PointerArchiveReader::numRows(std::size_t chunk) const
+{
+    return chunk < _chunkRows.size() ? _chunkRows[chunk] : 0;
+}
+
+
+const std::vector<std::string>& PointerArchiveReader::dictionary() const
+{
+    return _dictionary;
+}
+
+
+int64_t PointerArchiveReader::dictionaryId(const std::string& value) const
+{
+    auto iter = std::find(_dictionary.begin(), _dictionary.end(), value);
+    return iter == _dictionary.end() ? -1 : int64_t(iter - _dictionary.begin());
+}
+
+
+const PointerArchiveColumnStats& PointerArchiveReader::stats(std::size_t chunk,
+                                                              PointerArchiveColumn column) const
+{
+    static const PointerArchiveColumnStats EMPTY_STATS;
+
+    if (!_hasColumn(chunk, column))
+        return EMPTY_STATS;
+
+    return _chunkColumns[chunk][std::size_t(column)].stats;
+}
+
+
+bool PointerArchiveReader::mayContain(std::size_t chunk,
+                                      PointerArchiveColumn column,
+                                      int64_t minValue,
+                                      int64_t maxValue) const
+{
+    if (!_hasColumn(chunk, column))
+        return false;
+
+    const auto& s = stats(chunk, column);
+    return s.maxInteger >= minValue && s.minInteger <= maxValue;
+}
+
+
+bool PointerArchiveReader::mayContain(std::size_t chunk,
+                                      PointerArchiveColumn column,
+                                      float minValue,
+                                      float maxValue) const
+{
+    if (!_hasColumn(chunk, column))
+        return false;
+
+    const auto& s = stats(chunk, column);
+    return s.maxFloat >= minValue && s.minFloat <= maxValue;
+}
+
+
+bool PointerArchiveReader::readColumn(std::size_t chunk,
+                                      PointerArchiveColumn column,
+                                      std::vector<int64_t>& values)
+{
+    if (PointerArchiveFormat::isFloatColumn(column))
+    {
+        ofLogError("PointerArchiveReader::readColumn") << PointerArchiveFormat::columnName(column) << " is a float column.";
+        return false;
+    }
+
+    return _readColumn(chunk, column, values);
+}
+
+
+bool PointerArchiveReader::readColumn(std::size_t chunk,
+                                      PointerArchiveColumn column,
+                                      std::vector<float>& values)
+{
+    if (!PointerArchiveFormat::isFloatColumn(column))
+    {
+        ofLogError("PointerArchiveReader::readColumn") << PointerArchiveFormat::columnName(column) << " is an integer column.";
+        return false;
+    }
+
+    std::vector<int64_t> bits;
+
+    if (!_readColumn(chunk, column, bits))
+        return false;
+
+    values.resize(bits.size());
+
+    for (std::size_t i = 0; i < bits.size(); ++i)
+        values[i] = toFloat(bits[i]);
+
+    return true;
+}
+
+
+bool PointerArchiveReader::readEvents(std::size_t chunk, std::vector<PointerEventArgs>& events)
+{
+    events.clear();
+
+    std::array<std::vector<int64_t>, PointerArchiveFormat::NUM_COLUMNS> columns;
+
+    for (std::size_t i = 0; i < PointerArchiveFormat::NUM_COLUMNS; ++i)
+    {
+        if (!_readColumn(chunk, PointerArchiveColumn(i), columns[i]))
+            return false;
+    }
+
+    auto integer = [&](PointerArchiveColumn column, std::size_t row) {
+        return columns[std::size_t(column)][row];
+    };
+
+    auto number = [&](PointerArchiveColumn column, std::size_t row) {
+        return toFloat(columns[std::size_t(column)][row]);
+    };
+
+    auto string = [&](PointerArchiveColumn column, std::size_t row) -> const std::string* {
+        uint64_t id = uint64_t(integer(column, row));
+        return id < _dictionary.size() ? &_dictionary[std::size_t(id)] : nullptr;
+    };
+
+    auto sample = [&](std::size_t row) {
+        PointerSample result;
+        result.point = Point(glm::vec2(number(PointerArchiveColumn::POSITION_X, row),
+                                       number(PointerArchiveColumn::POSITION_Y, row)),
+                             glm::vec2(number(PointerArchiveColumn::PRECISE_POSITION_X, row),
+                                       number(PointerArchiveColumn::PRECISE_POSITION_Y, row)),
+                             PointShape(PointShape::ShapeType(integer(PointerArchiveColumn::SHAPE_TYPE, row)),
+                                        number(PointerArchiveColumn::WIDTH, row),
+                                        number(PointerArchiveColumn::HEIGHT, row),
+                                        number(PointerArchiveColumn::WIDTH_TOLERANCE, row),
+                                        number(PointerArchiveColumn::HEIGHT_TOLERANCE, row),
+                                        number(PointerArchiveColumn::ANGLE_DEG, row)),
+                             number(PointerArchiveColumn::PRESSURE, row),
+                             number(PointerArchiveColumn::TANGENTIAL_PRESSURE, row),
+                             number(PointerArchiveColumn::TWIST_DEG, row),
+                             number(PointerArchiveColumn::TILT_X_DEG, row),
+                             number(PointerArchiveColumn::TILT_Y_DEG, row));
+        result.timestampMicros = uint64_t(integer(PointerArchiveColumn::TIMESTAMP_MICROS, row));
+        result.sequenceIndex = uint64_t(integer(PointerArchiveColumn::SEQUENCE_INDEX, row));
+        result.flags = (integer(PointerArchiveColumn::IS_COALESCED, row) ? PointerSample::FLAG_COALESCED : PointerSample::FLAG_NONE)
+                     | (integer(PointerArchiveColumn::IS_PREDICTED, row) ? PointerSample::FLAG_PREDICTED : PointerSample::FLAG_NONE);
+        result.estimatedProperties = PointerPropertyMask(integer(PointerArchiveColumn::ESTIMATED_PROPERTIES, row));
+        result.estimatedPropertiesExpectingUpdates = PointerPropertyMask(integer(PointerArchiveColumn::ESTIMATED_PROPERTIES_EXPECTING_UPDATES, row));
+        return result;
+    };
+
+    std::size_t numRows = _chunkRows[chunk];
+    std::size_t row = 0;
+
+    while (row < numRows)
+    {
+        if (integer(PointerArchiveColumn::ROW_TYPE, row) != PointerArchiveFormat::ROW_EVENT)
+            return false;
+
+        std::size_t eventRow = row++;
+
+        PointerSampleBuffer coalesced;
+        PointerSampleBuffer predicted;
+
+        for (; row < numRows && integer(PointerArchiveColumn::ROW_TYPE, row) != PointerArchiveFormat::ROW_EVENT; ++row)
+        {
+            if (integer(PointerArchiveColumn::ROW_TYPE, row) == PointerArchiveFormat::ROW_COALESCED)
+                coalesced.push_back(sample(row));
+            else
+                predicted.push_back(sample(row));
+        }
+
+        const std::string* eventType = string(PointerArchiveColumn::EVENT_TYPE, eventRow);
+        const std::string* deviceType = string(PointerArchiveColumn::DEVICE_TYPE, eventRow);
+
+        if (!eventType || !deviceType)
+            return false;
+
+        PointerSample s = sample(eventRow);
+
+        events.push_back(PointerEventArgs::toPointerEventArgs(nullptr,
+                                                              *eventType,
+                                                              s.timestampMicros,
+                                                              uint64_t(integer(PointerArchiveColumn::DETAIL, eventRow)),
+                                                              s.point,
+                                                              std::size_t(integer(PointerArchiveColumn::POINTER_ID, eventRow)),
+                                                              integer(PointerArchiveColumn::DEVICE_ID, eventRow),
+                                                              integer(PointerArchiveColumn::POINTER_INDEX, eventRow),
+                                                              s.sequenceIndex,
+                                                              *deviceType,
+                                                              s.isCoalesced(),
+                                                              s.isPredicted(),
+                                                              integer(PointerArchiveColumn::IS_PRIMARY, eventRow) != 0,
+                                                              int16_t(integer(PointerArchiveColumn::BUTTON, eventRow)),
+                                                              uint16_t(integer(PointerArchiveColumn::BUTTONS, eventRow)),
+                                                              uint16_t(integer(PointerArchiveColumn::MODIFIERS, eventRow)),
+                                                              coalesced.samples(),
+                                                              predicted.samples(),
+                                                              s.estimatedProperties,
+                                                              s.estimatedPropertiesExpectingUpdates));
+    }
+
+    return true;
+}
+
+
+uint64_t PointerArchiveReader::numBytesRead() const
+{
+    return _numBytesRead;
+}
+
+
+bool PointerArchiveReader::_readFooter(uint64_t size)
+{
+    if (size < PointerArchiveFormat::HEADER_SIZE + ARCHIVE_TRAILER_SIZE)
+        return false;
+
+    uint8_t trailer[ARCHIVE_TRAILER_SIZE];
+    _stream.seekg(std::streamoff(size - ARCHIVE_TRAILER_SIZE));
+
+    if (!_stream.read(reinterpret_cast<char*>(trailer), sizeof(trailer))
+    || !std::equal(PointerArchiveFormat::MAGIC.begin(), PointerArchiveFormat::MAGIC.end(), trailer + 8))
+    {
+        return false;
+    }
+
+    uint64_t footerSize = readFixed(trailer, 8);
+
+    if (footerSize > size - PointerArchiveFormat::HEADER_SIZE - ARCHIVE_TRAILER_SIZE)
+        return false;
+
+    uint64_t footerOffset = size - ARCHIVE_TRAILER_SIZE - footerSize;
+
+    _buffer.resize(std::size_t(footerSize));
+    _stream.seekg(std::streamoff(footerOffset));
+
+    if (!_stream.read(reinterpret_cast<char*>(_buffer.data()), _buffer.size()))
+        return false;
+
+    const uint8_t* data = _buffer.data();
+    const uint8_t* end = data + _buffer.size();
+
+    uint64_t numRows = 0;
+    uint64_t dictionarySize = 0;
+
+    if (!readVarint(data, end, numRows)
+    ||  !readVarint(data, end, dictionarySize)
+    ||  dictionarySize > footerSize)
+    {
+        return false;
+    }
+
+    _dictionary.resize(std::size_t(dictionarySize));
+
+    for (auto& value: _dictionary)
+    {
+        if (!readString(data, end, value))
+            return false;
+    }
+
+    uint64_t numChunks = 0;
+
+    if (!readVarint(data, end, numChunks) || numChunks > footerSize)
+        return false;
+
+    uint64_t totalRows = 0;
+
+    // The end of the previous chunk.
+    uint64_t chunkEnd = PointerArchiveFormat::HEADER_SIZE;
+
+    for (uint64_t chunk = 0; chunk < numChunks; ++chunk)
+    {
+        uint64_t chunkRows = 0;
+        uint64_t offset = 0;
+
+        // Chunks are stored in order between the header and the footer.
+        if (!readVarint(data, end, chunkRows)
+        ||  !readVarint(data, end, offset)
+        ||  offset < chunkEnd
+        ||  offset > footerOffset)
+        {
+            return false;
+        }
+
+        std::array<PointerArchiveColumnInfo, PointerArchiveFormat::NUM_COLUMNS> columns;
+
+        for (std::size_t i = 0; i < PointerArchiveFormat::NUM_COLUMNS; ++i)
+        {
+            auto& info = columns[i];
+            info.offset = offset;
+
+            // Every row takes at least one byte in every column.
+            if (!readVarint(data, end, info.size)
+            ||  info.size > footerOffset - offset
+            ||  chunkRows > info.size)
+            {
+                return false;
+            }
+
+            offset += info.size;
+
+            if (PointerArchiveFormat::isFloatColumn(PointerArchiveColumn(i)))
+            {
+                if (!readFloat(data, end, info.stats.minFloat) || !readFloat(data, end, info.stats.maxFloat))
+                    return false;
+            }
+            else
+            {
+                if (!readSigned(data, end, info.stats.minInteger) || !readSigned(data, end, info.stats.maxInteger))
+                    return false;
+            }
+        }
+
+        chunkEnd = offset;
+        totalRows += chunkRows;
+        _chunkRows.push_back(std::size_t(chunkRows));
+        _chunkColumns.push_back(columns);
+    }
+
+    _numRows = std::size_t(numRows);
+    return data == end && totalRows == numRows;
+}
+
+
+bool PointerArchiveReader::_readColumn(std::size_t chunk,
+                                       PointerArchiveColumn column,
+                                       std::vector<int64_t>& values)
+{
+    if (!_isOpen || !_hasColumn(chunk, column))
+        return false;
+
+    const auto& info = _chunkColumns[chunk][std::size_t(column)];
+    std::size_t numRows = _chunkRows[chunk];
+
+    _buffer.resize(std::size_t(info.size));
+    _stream.clear();
+    _stream.seekg(std::streamoff(info.offset));
+
+    if (!_stream.read(reinterpret_cast<char*>(_buffer.data()), _buffer.size()))
+    {
+        ofLogError("PointerArchiveReader::readColumn") << "Unable to read " << PointerArchiveFormat::columnName(column) << ".";
+        return false;
+    }
+
+    _numBytesRead += _buffer.size();
+
+    const uint8_t* data = _buffer.data();
+    const uint8_t* end = data + _buffer.size();
+
+    values.resize(numRows);
+
+    bool isFloat = PointerArchiveFormat::isFloatColumn(column);
+    bool isQuantized = isFloat && _format.positionScale > 0 && isPositionColumn(column);
+    int64_t previous = 0;
+
+    for (auto& value: values)
+    {
+        if (isFloat && !isQuantized)
+        {
+            uint64_t bits = 0;
+
+            if (!readVarint(data, end, bits))
+                return false;
+
+            value = int64_t(bits) ^ previous;
+        }
+        else
+        {
+            int64_t delta = 0;
+
+            if (!readSigned(data, end, delta))
+                return false;
+
+            value = int64_t(uint64_t(previous) + uint64_t(delta));
+        }
+
+        previous = value;
+    }
+
+    // Quantized positions are decoded to the bits of their float values.
+    if (isQuantized)
+    {
+        for (auto& value: values)
+            value = toBits(float(double(value) / _format.positionScale));
+    }
+
+    return data == end;
+}
+
+
+bool PointerArchiveReader::_hasColumn(std::size_t chunk, PointerArchiveColumn column) const
+{
+    return chunk < _chunkColumns.size()
+        && std::size_t(column) < PointerArchiveFormat::NUM_COLUMNS;
+}
+
+
+} // namespace ofx
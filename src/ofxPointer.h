@@ -9,6 +9,9 @@
 
 #include "ofConstants.h"
 #include "ofx/PointerEvents.h"
+#include "ofx/PointerJson.h"
+#include "ofx/PointerPredictor.h"
+#include "ofx/PointerRecording.h"
 
 #if defined(TARGET_OF_IOS)
 #include "ofx/PointerEventsiOS.h"